@@ -0,0 +1,132 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <stdexcept>
+#include <filesystem>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Read-only memory mapping of a whole file
+class MappedFile
+{
+public:
+    MappedFile() = default;
+
+    explicit MappedFile(const std::filesystem::path &path)
+    {
+        Map(path);
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile()
+    {
+        Unmap();
+    }
+
+    void Map(const std::filesystem::path &path)
+    {
+        Unmap();
+
+#ifdef _WIN32
+        HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                  nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            throw std::runtime_error("MappedFile: Cannot open '" + path.string() + "'.");
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size))
+        {
+            CloseHandle(file);
+            throw std::runtime_error("MappedFile: Cannot stat '" + path.string() + "'.");
+        }
+
+        size_ = static_cast<std::size_t>(size.QuadPart);
+        if (size_ == 0)
+        {
+            CloseHandle(file);
+            return;
+        }
+
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (mapping == nullptr)
+        {
+            size_ = 0;
+            throw std::runtime_error("MappedFile: Cannot map '" + path.string() + "'.");
+        }
+
+        data_ = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping);
+        if (data_ == nullptr)
+        {
+            size_ = 0;
+            throw std::runtime_error("MappedFile: Cannot map '" + path.string() + "'.");
+        }
+#else
+        const int file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0)
+        {
+            throw std::runtime_error("MappedFile: Cannot open '" + path.string() + "'.");
+        }
+
+        struct stat status;
+        if (::fstat(file, &status) != 0)
+        {
+            ::close(file);
+            throw std::runtime_error("MappedFile: Cannot stat '" + path.string() + "'.");
+        }
+
+        size_ = static_cast<std::size_t>(status.st_size);
+        if (size_ == 0)
+        {
+            ::close(file);
+            return;
+        }
+
+        void *data = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, file, 0);
+        ::close(file);
+        if (data == MAP_FAILED)
+        {
+            size_ = 0;
+            throw std::runtime_error("MappedFile: Cannot map '" + path.string() + "'.");
+        }
+        data_ = static_cast<const char *>(data);
+#endif
+    }
+
+    void Unmap() noexcept
+    {
+        if (data_ != nullptr)
+        {
+#ifdef _WIN32
+            UnmapViewOfFile(data_);
+#else
+            ::munmap(const_cast<char *>(data_), size_);
+#endif
+        }
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    const char *GetData() const noexcept { return data_; }
+    std::size_t GetSize() const noexcept { return size_; }
+
+private:
+    const char *data_ = nullptr;
+    std::size_t size_ = 0;
+};
@@ -0,0 +1,620 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <algorithm>
+#include <filesystem>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "Study.h"
+#include "DateTimeUtils.h"
+#include "MappedFile.h"
+
+// On-disk layout of a RoundArchive (native byte order, 8-byte aligned).
+//
+//   FileHeader
+//   Segment*          one per archived round, appended in order
+//
+// A segment is
+//
+//   SegmentHeader
+//   LaboratoryEntry[laboratoryCount]   sorted by laboratory id
+//   SampleEntry[sampleCount]
+//   ArchivedResult[recordCount]        grouped by laboratory, then sample, replicate
+//   char[stringBytes]                  all ids and texts, referenced by StringRef
+//
+// Offsets inside a segment are relative to the segment start; StringRef
+// offsets are relative to the segment's string table.
+namespace ArchiveFormat
+{
+    constexpr char FileMagic[8] = {'I', 'L', 'C', 'A', 'R', 'C', 'H', '1'};
+    constexpr std::uint32_t FileVersion = 1;
+    constexpr std::uint32_t SegmentMagic = 0x4D474553; // "SEGM"
+    constexpr std::int64_t NoTimestamp = std::numeric_limits<std::int64_t>::max();
+
+    struct FileHeader
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t reserved;
+    };
+
+    struct StringRef
+    {
+        std::uint32_t offset;
+        std::uint32_t length;
+    };
+
+    struct SegmentHeader
+    {
+        std::uint32_t magic;
+        std::uint32_t reserved;
+        std::uint64_t segmentSize;
+        std::int64_t endDateEpochMillis;
+        std::uint32_t laboratoryCount;
+        std::uint32_t sampleCount;
+        std::uint32_t recordCount;
+        std::uint32_t stringBytes;
+        std::uint64_t laboratoryTableOffset;
+        std::uint64_t sampleTableOffset;
+        std::uint64_t recordTableOffset;
+        std::uint64_t stringTableOffset;
+        StringRef studyId;
+        StringRef title;
+        StringRef startDate;
+        StringRef endDate;
+    };
+
+    struct LaboratoryEntry
+    {
+        StringRef laboratoryId;
+        std::uint32_t firstRecord;
+        std::uint32_t recordCount;
+    };
+
+    struct SampleEntry
+    {
+        StringRef sampleId;
+        StringRef measurandId;
+        double assignedValue;       // NaN when not set
+        double standardUncertainty; // NaN when not set
+    };
+
+    constexpr std::uint64_t Align8(std::uint64_t value) noexcept
+    {
+        return (value + 7) & ~static_cast<std::uint64_t>(7);
+    }
+}
+
+// One archived result; read in place from the mapped file
+struct ArchivedResult
+{
+    std::uint32_t sampleIndex;
+    std::int32_t replicateIndex;
+    double value;
+    std::int64_t timestampEpochMillis; // ArchiveFormat::NoTimestamp when not set
+
+    bool HasTimestamp() const noexcept { return timestampEpochMillis != ArchiveFormat::NoTimestamp; }
+};
+
+static_assert(sizeof(ArchiveFormat::FileHeader) == 16, "Archive layout changed");
+static_assert(sizeof(ArchiveFormat::SegmentHeader) == 104, "Archive layout changed");
+static_assert(sizeof(ArchiveFormat::LaboratoryEntry) == 16, "Archive layout changed");
+static_assert(sizeof(ArchiveFormat::SampleEntry) == 32, "Archive layout changed");
+static_assert(sizeof(ArchivedResult) == 24, "Archive layout changed");
+static_assert(std::is_trivially_copyable_v<ArchivedResult>, "ArchivedResult must be trivially copyable");
+
+struct ArchivedSample
+{
+    std::string_view sampleId;
+    std::string_view measurandId;
+    std::optional<double> assignedValue;
+    std::optional<double> standardUncertainty;
+};
+
+// View of one archived round. Valid until the next RoundArchive::AppendRound.
+class ArchivedRound
+{
+public:
+    ArchivedRound(const char *segment, std::size_t roundIndex) noexcept
+        : segment_(segment),
+          header_(reinterpret_cast<const ArchiveFormat::SegmentHeader *>(segment)),
+          roundIndex_(roundIndex)
+    {
+    }
+
+    std::size_t GetRoundIndex() const noexcept { return roundIndex_; }
+
+    std::string_view GetStudyId() const noexcept { return GetString(header_->studyId); }
+    std::string_view GetTitle() const noexcept { return GetString(header_->title); }
+    std::string_view GetStartDateIso8601() const noexcept { return GetString(header_->startDate); }
+    std::string_view GetEndDateIso8601() const noexcept { return GetString(header_->endDate); }
+
+    std::optional<std::int64_t> GetEndDateEpochMillis() const noexcept
+    {
+        if (header_->endDateEpochMillis == ArchiveFormat::NoTimestamp)
+        {
+            return std::nullopt;
+        }
+        return header_->endDateEpochMillis;
+    }
+
+    std::size_t GetLaboratoryCount() const noexcept { return header_->laboratoryCount; }
+    std::size_t GetSampleCount() const noexcept { return header_->sampleCount; }
+    std::size_t GetResultCount() const noexcept { return header_->recordCount; }
+
+    std::string_view GetLaboratoryId(std::size_t laboratoryIndex) const
+    {
+        return GetString(GetLaboratoryEntry(laboratoryIndex).laboratoryId);
+    }
+
+    ArchivedSample GetSample(std::size_t sampleIndex) const
+    {
+        if (sampleIndex >= header_->sampleCount)
+        {
+            throw std::out_of_range("ArchivedRound::GetSample: Index out of range.");
+        }
+
+        const auto &entry = reinterpret_cast<const ArchiveFormat::SampleEntry *>(segment_ + header_->sampleTableOffset)[sampleIndex];
+        ArchivedSample sample;
+        sample.sampleId = GetString(entry.sampleId);
+        sample.measurandId = GetString(entry.measurandId);
+        if (!std::isnan(entry.assignedValue))
+        {
+            sample.assignedValue = entry.assignedValue;
+        }
+        if (!std::isnan(entry.standardUncertainty))
+        {
+            sample.standardUncertainty = entry.standardUncertainty;
+        }
+        return sample;
+    }
+
+    const ArchivedResult *GetResults() const noexcept
+    {
+        return reinterpret_cast<const ArchivedResult *>(segment_ + header_->recordTableOffset);
+    }
+
+    // Results of one laboratory; contiguous, ordered by sample and replicate
+    const ArchivedResult *GetLaboratoryResults(std::size_t laboratoryIndex, std::size_t &count) const
+    {
+        const auto &entry = GetLaboratoryEntry(laboratoryIndex);
+        count = entry.recordCount;
+        return GetResults() + entry.firstRecord;
+    }
+
+    // Binary search over the sorted laboratory table
+    std::optional<std::size_t> FindLaboratoryIndex(std::string_view laboratoryId) const noexcept
+    {
+        std::size_t low = 0;
+        std::size_t high = header_->laboratoryCount;
+        while (low < high)
+        {
+            const std::size_t middle = low + (high - low) / 2;
+            const std::string_view current = GetString(LaboratoryTable()[middle].laboratoryId);
+            if (current < laboratoryId)
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+
+        if (low < header_->laboratoryCount && GetString(LaboratoryTable()[low].laboratoryId) == laboratoryId)
+        {
+            return low;
+        }
+        return std::nullopt;
+    }
+
+private:
+    const char *segment_;
+    const ArchiveFormat::SegmentHeader *header_;
+    std::size_t roundIndex_;
+
+    const ArchiveFormat::LaboratoryEntry *LaboratoryTable() const noexcept
+    {
+        return reinterpret_cast<const ArchiveFormat::LaboratoryEntry *>(segment_ + header_->laboratoryTableOffset);
+    }
+
+    const ArchiveFormat::LaboratoryEntry &GetLaboratoryEntry(std::size_t laboratoryIndex) const
+    {
+        if (laboratoryIndex >= header_->laboratoryCount)
+        {
+            throw std::out_of_range("ArchivedRound: Laboratory index out of range.");
+        }
+        return LaboratoryTable()[laboratoryIndex];
+    }
+
+    std::string_view GetString(const ArchiveFormat::StringRef &ref) const noexcept
+    {
+        return std::string_view(segment_ + header_->stringTableOffset + ref.offset, ref.length);
+    }
+};
+
+// One laboratory's results in one archived round
+struct LaboratoryRoundResults
+{
+    ArchivedRound round;
+    const ArchivedResult *results;
+    std::size_t resultCount;
+
+    const ArchivedResult *begin() const noexcept { return results; }
+    const ArchivedResult *end() const noexcept { return results + resultCount; }
+};
+
+// Append-only, memory-mapped store of evaluated rounds with a per-laboratory
+// index across rounds.
+//
+// Each AppendRound writes one self-contained segment to the end of the file.
+// Opening the archive maps the file and reads only segment headers and
+// laboratory tables, so a laboratory's full history is a hash lookup plus
+// one contiguous slice per round, read in place without copying. A torn
+// segment at the end of the file (e.g. after a crash during append) is
+// ignored and overwritten by the next append.
+class RoundArchive
+{
+public:
+    explicit RoundArchive(std::filesystem::path path)
+        : path_(std::move(path))
+    {
+        if (!std::filesystem::exists(path_))
+        {
+            CreateEmptyFile();
+        }
+
+        Load();
+    }
+
+    RoundArchive(const RoundArchive &) = delete;
+    RoundArchive &operator=(const RoundArchive &) = delete;
+
+    const std::filesystem::path &GetPath() const noexcept { return path_; }
+
+    std::size_t GetRoundCount() const noexcept { return segmentOffsets_.size(); }
+
+    ArchivedRound GetRound(std::size_t roundIndex) const
+    {
+        if (roundIndex >= segmentOffsets_.size())
+        {
+            throw std::out_of_range("RoundArchive::GetRound: Index out of range.");
+        }
+        return ArchivedRound(file_.GetData() + segmentOffsets_[roundIndex], roundIndex);
+    }
+
+    bool ContainsStudy(std::string_view studyId) const
+    {
+        return studyIds_.find(std::string(StringUtils::TrimView(studyId))) != studyIds_.end();
+    }
+
+    // All rounds a laboratory took part in, in archive order
+    std::vector<LaboratoryRoundResults> GetLaboratoryHistory(std::string_view laboratoryId) const
+    {
+        std::vector<LaboratoryRoundResults> history;
+
+        const auto it = laboratoryIndex_.find(std::string(StringUtils::TrimView(laboratoryId)));
+        if (it == laboratoryIndex_.end())
+        {
+            return history;
+        }
+
+        history.reserve(it->second.size());
+        for (const auto &[roundIndex, laboratoryIndex] : it->second)
+        {
+            const ArchivedRound round = GetRound(roundIndex);
+            std::size_t count = 0;
+            const ArchivedResult *results = round.GetLaboratoryResults(laboratoryIndex, count);
+            history.push_back({round, results, count});
+        }
+        return history;
+    }
+
+    // Appends the study as a new round. Views obtained earlier become invalid.
+    void AppendRound(const Study &study)
+    {
+        if (ContainsStudy(study.GetStudyId()))
+        {
+            throw std::invalid_argument("AppendRound: Study is already archived.");
+        }
+
+        const std::vector<char> segment = BuildSegment(study);
+
+        file_.Unmap();
+        if (std::filesystem::file_size(path_) != validSize_)
+        {
+            // Drop a torn segment left behind by an interrupted append
+            std::filesystem::resize_file(path_, validSize_);
+        }
+
+        std::FILE *file = std::fopen(path_.string().c_str(), "ab");
+        if (file == nullptr)
+        {
+            Load();
+            throw std::runtime_error("AppendRound: Cannot open archive for appending.");
+        }
+
+        const bool written = std::fwrite(segment.data(), 1, segment.size(), file) == segment.size();
+        const bool closed = std::fclose(file) == 0;
+
+        Load();
+        if (!written || !closed)
+        {
+            throw std::runtime_error("AppendRound: Write failed.");
+        }
+    }
+
+private:
+    std::filesystem::path path_;
+    MappedFile file_;
+    std::uint64_t validSize_ = 0;
+    std::vector<std::uint64_t> segmentOffsets_;
+    std::unordered_set<std::string> studyIds_;
+
+    // LaboratoryId -> (round index, laboratory index in that round)
+    std::unordered_map<std::string, std::vector<std::pair<std::uint32_t, std::uint32_t>>> laboratoryIndex_;
+
+    void CreateEmptyFile()
+    {
+        ArchiveFormat::FileHeader header{};
+        std::memcpy(header.magic, ArchiveFormat::FileMagic, sizeof(header.magic));
+        header.version = ArchiveFormat::FileVersion;
+
+        std::FILE *file = std::fopen(path_.string().c_str(), "wb");
+        if (file == nullptr)
+        {
+            throw std::runtime_error("RoundArchive: Cannot create '" + path_.string() + "'.");
+        }
+
+        const bool written = std::fwrite(&header, sizeof(header), 1, file) == 1;
+        if (std::fclose(file) != 0 || !written)
+        {
+            throw std::runtime_error("RoundArchive: Cannot write '" + path_.string() + "'.");
+        }
+    }
+
+    void Load()
+    {
+        file_.Map(path_);
+        segmentOffsets_.clear();
+        studyIds_.clear();
+        laboratoryIndex_.clear();
+
+        const char *data = file_.GetData();
+        const std::uint64_t size = file_.GetSize();
+
+        ArchiveFormat::FileHeader fileHeader;
+        if (size < sizeof(fileHeader))
+        {
+            throw std::runtime_error("RoundArchive: File is not an archive.");
+        }
+        std::memcpy(&fileHeader, data, sizeof(fileHeader));
+        if (std::memcmp(fileHeader.magic, ArchiveFormat::FileMagic, sizeof(fileHeader.magic)) != 0)
+        {
+            throw std::runtime_error("RoundArchive: File is not an archive.");
+        }
+        if (fileHeader.version != ArchiveFormat::FileVersion)
+        {
+            throw std::runtime_error("RoundArchive: Unsupported archive version.");
+        }
+
+        std::uint64_t offset = sizeof(fileHeader);
+        while (offset + sizeof(ArchiveFormat::SegmentHeader) <= size)
+        {
+            const auto *header = reinterpret_cast<const ArchiveFormat::SegmentHeader *>(data + offset);
+            if (header->magic != ArchiveFormat::SegmentMagic || header->segmentSize > size - offset)
+            {
+                break;
+            }
+
+            ValidateSegment(*header);
+            IndexSegment(data + offset);
+            offset += header->segmentSize;
+        }
+
+        validSize_ = offset;
+    }
+
+    // Every segment advances the read offset by a multiple of 8 bytes, and its
+    // tables lie between the end of its header and the end of the segment
+    static void ValidateSegment(const ArchiveFormat::SegmentHeader &header)
+    {
+        constexpr std::uint64_t headerSize = ArchiveFormat::Align8(sizeof(ArchiveFormat::SegmentHeader));
+        const std::uint64_t size = header.segmentSize;
+        if (size < headerSize || size % 8 != 0)
+        {
+            throw std::runtime_error("RoundArchive: Corrupt segment size.");
+        }
+
+        const auto fits = [size](std::uint64_t tableOffset, std::uint64_t count, std::uint64_t elementSize)
+        {
+            return tableOffset % 8 == 0 && tableOffset >= headerSize && tableOffset <= size &&
+                   count <= (size - tableOffset) / elementSize;
+        };
+
+        if (!fits(header.laboratoryTableOffset, header.laboratoryCount, sizeof(ArchiveFormat::LaboratoryEntry)) ||
+            !fits(header.sampleTableOffset, header.sampleCount, sizeof(ArchiveFormat::SampleEntry)) ||
+            !fits(header.recordTableOffset, header.recordCount, sizeof(ArchivedResult)) ||
+            !fits(header.stringTableOffset, header.stringBytes, 1))
+        {
+            throw std::runtime_error("RoundArchive: Corrupt segment.");
+        }
+    }
+
+    void IndexSegment(const char *segment)
+    {
+        const auto *header = reinterpret_cast<const ArchiveFormat::SegmentHeader *>(segment);
+        const auto roundIndex = static_cast<std::uint32_t>(segmentOffsets_.size());
+
+        const auto checkString = [header](const ArchiveFormat::StringRef &ref)
+        {
+            if (ref.offset > header->stringBytes || ref.length > header->stringBytes - ref.offset)
+            {
+                throw std::runtime_error("RoundArchive: Corrupt string reference.");
+            }
+        };
+
+        checkString(header->studyId);
+        checkString(header->title);
+        checkString(header->startDate);
+        checkString(header->endDate);
+
+        const auto *samples = reinterpret_cast<const ArchiveFormat::SampleEntry *>(segment + header->sampleTableOffset);
+        for (std::uint32_t index = 0; index < header->sampleCount; ++index)
+        {
+            checkString(samples[index].sampleId);
+            checkString(samples[index].measurandId);
+        }
+
+        const auto *results = reinterpret_cast<const ArchivedResult *>(segment + header->recordTableOffset);
+        for (std::uint32_t index = 0; index < header->recordCount; ++index)
+        {
+            if (results[index].sampleIndex >= header->sampleCount)
+            {
+                throw std::runtime_error("RoundArchive: Corrupt result record.");
+            }
+        }
+
+        const char *strings = segment + header->stringTableOffset;
+        const auto *laboratories = reinterpret_cast<const ArchiveFormat::LaboratoryEntry *>(segment + header->laboratoryTableOffset);
+        for (std::uint32_t index = 0; index < header->laboratoryCount; ++index)
+        {
+            const auto &entry = laboratories[index];
+            checkString(entry.laboratoryId);
+            if (entry.firstRecord > header->recordCount || entry.recordCount > header->recordCount - entry.firstRecord)
+            {
+                throw std::runtime_error("RoundArchive: Corrupt laboratory entry.");
+            }
+
+            laboratoryIndex_[std::string(strings + entry.laboratoryId.offset, entry.laboratoryId.length)]
+                .emplace_back(roundIndex, index);
+        }
+
+        studyIds_.emplace(strings + header->studyId.offset, header->studyId.length);
+        segmentOffsets_.push_back(static_cast<std::uint64_t>(segment - file_.GetData()));
+    }
+
+    static std::vector<char> BuildSegment(const Study &study)
+    {
+        std::string strings;
+        const auto addString = [&strings](std::string_view text)
+        {
+            const ArchiveFormat::StringRef ref{static_cast<std::uint32_t>(strings.size()), static_cast<std::uint32_t>(text.size())};
+            strings.append(text);
+            return ref;
+        };
+
+        // Laboratories, sorted by id so rounds can be binary searched
+        std::vector<std::string_view> laboratoryIds;
+        laboratoryIds.reserve(study.GetLaboratoryCount());
+        study.ForEachLaboratory([&](const Laboratory &laboratory)
+                                { laboratoryIds.push_back(laboratory.GetLaboratoryId()); });
+        std::sort(laboratoryIds.begin(), laboratoryIds.end());
+
+        // Samples, in study order
+        std::vector<ArchiveFormat::SampleEntry> sampleEntries;
+        std::unordered_map<std::string_view, std::uint32_t> sampleIndexes;
+        sampleEntries.reserve(study.GetSampleCount());
+        study.ForEachSample([&](const Sample &sample)
+                            {
+                                sampleIndexes.emplace(sample.GetSampleId(), static_cast<std::uint32_t>(sampleEntries.size()));
+                                sampleEntries.push_back({addString(sample.GetSampleId()),
+                                                         addString(sample.GetMeasurandId()),
+                                                         sample.GetAssignedValue().value_or(std::numeric_limits<double>::quiet_NaN()),
+                                                         sample.GetStandardUncertainty().value_or(std::numeric_limits<double>::quiet_NaN())});
+                            });
+
+        // Results, grouped by laboratory in the same order as the laboratory table
+        // Timestamps come from the study's time index, which has them parsed already
+        static_assert(ArchiveFormat::NoTimestamp == Study::NoTimestamp, "Archive and study must agree on NoTimestamp");
+        std::vector<std::pair<const MeasurementResult *, std::int64_t>> sortedResults;
+        sortedResults.reserve(study.GetMeasurementResultCount());
+        study.ForEachMeasurementResultByTime([&](const MeasurementResult &result, std::int64_t epochMillis)
+                                             { sortedResults.emplace_back(&result, epochMillis); });
+        std::sort(sortedResults.begin(), sortedResults.end(),
+                  [](const auto &aEntry, const auto &bEntry)
+                  {
+                      const MeasurementResult *a = aEntry.first;
+                      const MeasurementResult *b = bEntry.first;
+                      const std::string_view aLab = a->GetLaboratoryId();
+                      const std::string_view bLab = b->GetLaboratoryId();
+                      if (aLab != bLab)
+                      {
+                          return aLab < bLab;
+                      }
+                      const std::string_view aSample = a->GetSampleId();
+                      const std::string_view bSample = b->GetSampleId();
+                      if (aSample != bSample)
+                      {
+                          return aSample < bSample;
+                      }
+                      return a->GetReplicateIndex() < b->GetReplicateIndex();
+                  });
+
+        std::vector<ArchivedResult> records;
+        records.reserve(sortedResults.size());
+        for (const auto &[result, timestamp] : sortedResults)
+        {
+            records.push_back({sampleIndexes.at(result->GetSampleId()), result->GetReplicateIndex(), result->GetValue(), timestamp});
+        }
+
+        std::vector<ArchiveFormat::LaboratoryEntry> laboratoryEntries;
+        laboratoryEntries.reserve(laboratoryIds.size());
+        std::size_t next = 0;
+        for (const std::string_view laboratoryId : laboratoryIds)
+        {
+            const std::size_t first = next;
+            while (next < sortedResults.size() && sortedResults[next].first->GetLaboratoryId() == laboratoryId)
+            {
+                ++next;
+            }
+            laboratoryEntries.push_back({addString(laboratoryId), static_cast<std::uint32_t>(first), static_cast<std::uint32_t>(next - first)});
+        }
+
+        ArchiveFormat::SegmentHeader header{};
+        header.magic = ArchiveFormat::SegmentMagic;
+        header.studyId = addString(study.GetStudyId());
+        header.title = addString(study.GetTitle());
+        header.startDate = addString(study.GetStartDateIso8601());
+        header.endDate = addString(study.GetEndDateIso8601());
+        header.endDateEpochMillis = DateTimeUtils::ParseIso8601ToEpochMillis(study.GetEndDateIso8601()).value_or(ArchiveFormat::NoTimestamp);
+        header.laboratoryCount = static_cast<std::uint32_t>(laboratoryEntries.size());
+        header.sampleCount = static_cast<std::uint32_t>(sampleEntries.size());
+        header.recordCount = static_cast<std::uint32_t>(records.size());
+        header.stringBytes = static_cast<std::uint32_t>(strings.size());
+
+        header.laboratoryTableOffset = ArchiveFormat::Align8(sizeof(header));
+        header.sampleTableOffset = ArchiveFormat::Align8(header.laboratoryTableOffset + laboratoryEntries.size() * sizeof(ArchiveFormat::LaboratoryEntry));
+        header.recordTableOffset = ArchiveFormat::Align8(header.sampleTableOffset + sampleEntries.size() * sizeof(ArchiveFormat::SampleEntry));
+        header.stringTableOffset = ArchiveFormat::Align8(header.recordTableOffset + records.size() * sizeof(ArchivedResult));
+        header.segmentSize = ArchiveFormat::Align8(header.stringTableOffset + strings.size());
+
+        std::vector<char> segment(header.segmentSize, '\0');
+        std::memcpy(segment.data(), &header, sizeof(header));
+        if (!laboratoryEntries.empty())
+        {
+            std::memcpy(segment.data() + header.laboratoryTableOffset, laboratoryEntries.data(), laboratoryEntries.size() * sizeof(ArchiveFormat::LaboratoryEntry));
+        }
+        if (!sampleEntries.empty())
+        {
+            std::memcpy(segment.data() + header.sampleTableOffset, sampleEntries.data(), sampleEntries.size() * sizeof(ArchiveFormat::SampleEntry));
+        }
+        if (!records.empty())
+        {
+            std::memcpy(segment.data() + header.recordTableOffset, records.data(), records.size() * sizeof(ArchivedResult));
+        }
+        std::memcpy(segment.data() + header.stringTableOffset, strings.data(), strings.size());
+        return segment;
+    }
+};
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <stdexcept>
+#include <algorithm>
+#include <unordered_map>
+
+#include "MeasurementResult.h"
+#include "Study.h"
+#include "DateTimeUtils.h"
+
+// Fixed-size, string-free form of a MeasurementResult.
+// Laboratory and sample ids are interned into the owning CompactResultTable,
+// notes live out of line, and the timestamp is the epoch from the study's
+// time index (NoTimestamp when there is none or it could not be parsed).
+struct CompactMeasurementResult
+{
+    static constexpr std::int64_t NoTimestamp = Study::NoTimestamp;
+    static constexpr std::uint32_t NoNotes = std::numeric_limits<std::uint32_t>::max();
+
+    double value = 0.0;
+    std::int64_t timestampEpochMillis = NoTimestamp;
+    std::uint32_t laboratoryIndex = 0;
+    std::uint32_t sampleIndex = 0;
+    std::int32_t replicateIndex = 0;
+    std::uint32_t notesIndex = NoNotes;
+
+    bool HasTimestamp() const noexcept { return timestampEpochMillis != NoTimestamp; }
+};
+
+static_assert(sizeof(CompactMeasurementResult) == 32, "CompactMeasurementResult should stay 32 bytes");
+
+// Read-only, time-sorted copy of a study's results in 32-byte records, for
+// handing a round to code that has no use for the strings (e.g. plotting or
+// export) or for keeping it after the study is gone.
+//
+// Time-range queries on a live study do not need this table: Study keeps its
+// own time index (Study::ForEachMeasurementResultInTimeRange). The table is a
+// snapshot in addition to the study's storage and does not follow later
+// changes; rebuild it after the study's results change.
+class CompactResultTable
+{
+public:
+    using const_iterator = std::vector<CompactMeasurementResult>::const_iterator;
+
+    // A contiguous slice of records
+    struct Range
+    {
+        const_iterator first;
+        const_iterator last;
+
+        const_iterator begin() const noexcept { return first; }
+        const_iterator end() const noexcept { return last; }
+        std::size_t size() const noexcept { return static_cast<std::size_t>(last - first); }
+        bool empty() const noexcept { return first == last; }
+    };
+
+    CompactResultTable() = default;
+
+    explicit CompactResultTable(const Study &study)
+    {
+        records_.reserve(study.GetMeasurementResultCount());
+
+        std::unordered_map<std::string_view, std::uint32_t> laboratoryLookup;
+        std::unordered_map<std::string_view, std::uint32_t> sampleLookup;
+
+        // The study's time index already yields the results in timestamp order
+        study.ForEachMeasurementResultByTime([&](const MeasurementResult &result, std::int64_t epochMillis)
+        {
+            CompactMeasurementResult record;
+            record.value = result.GetValue();
+            record.replicateIndex = result.GetReplicateIndex();
+            record.laboratoryIndex = Intern(laboratoryIds_, laboratoryLookup, result.GetLaboratoryId());
+            record.sampleIndex = Intern(sampleIds_, sampleLookup, result.GetSampleId());
+
+            record.timestampEpochMillis = epochMillis;
+
+            if (!result.GetNotes().empty())
+            {
+                record.notesIndex = static_cast<std::uint32_t>(notes_.size());
+                notes_.emplace_back(result.GetNotes());
+            }
+
+            records_.push_back(record);
+        });
+    }
+
+    std::size_t GetSize() const noexcept { return records_.size(); }
+
+    // All records, in ascending timestamp order
+    Range GetRecords() const noexcept { return {records_.begin(), records_.end()}; }
+
+    // Records with fromEpochMillis <= timestamp < toEpochMillis
+    Range GetRecordsInTimeRange(std::int64_t fromEpochMillis, std::int64_t toEpochMillis) const
+    {
+        const auto first = std::lower_bound(
+            records_.begin(), records_.end(), fromEpochMillis,
+            [](const CompactMeasurementResult &record, std::int64_t time)
+            { return record.timestampEpochMillis < time; });
+
+        const auto last = std::lower_bound(
+            first, records_.end(), std::max(fromEpochMillis, toEpochMillis),
+            [](const CompactMeasurementResult &record, std::int64_t time)
+            { return record.timestampEpochMillis < time; });
+
+        return {first, last};
+    }
+
+    // Same as above with ISO 8601 bounds
+    Range GetRecordsInTimeRange(std::string_view fromIso8601, std::string_view toIso8601) const
+    {
+        const auto from = DateTimeUtils::ParseIso8601ToEpochMillis(fromIso8601);
+        const auto to = DateTimeUtils::ParseIso8601ToEpochMillis(toIso8601);
+        if (!from.has_value() || !to.has_value())
+        {
+            throw std::invalid_argument("GetRecordsInTimeRange: Invalid ISO 8601 bound.");
+        }
+
+        return GetRecordsInTimeRange(from.value(), to.value());
+    }
+
+    const std::string &GetLaboratoryId(const CompactMeasurementResult &record) const
+    {
+        return laboratoryIds_.at(record.laboratoryIndex);
+    }
+
+    const std::string &GetSampleId(const CompactMeasurementResult &record) const
+    {
+        return sampleIds_.at(record.sampleIndex);
+    }
+
+    std::string_view GetNotes(const CompactMeasurementResult &record) const
+    {
+        if (record.notesIndex == CompactMeasurementResult::NoNotes)
+        {
+            return {};
+        }
+        return notes_.at(record.notesIndex);
+    }
+
+private:
+    std::vector<CompactMeasurementResult> records_;
+    std::vector<std::string> laboratoryIds_;
+    std::vector<std::string> sampleIds_;
+    std::vector<std::string> notes_;
+
+    // Views in lookup point into the study's results, which outlive construction
+    static std::uint32_t Intern(
+        std::vector<std::string> &ids,
+        std::unordered_map<std::string_view, std::uint32_t> &lookup,
+        std::string_view id)
+    {
+        const auto [it, inserted] = lookup.emplace(id, static_cast<std::uint32_t>(ids.size()));
+        if (inserted)
+        {
+            ids.emplace_back(id);
+        }
+        return it->second;
+    }
+};
@@ -1,78 +1,129 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <memory>
+#include <memory_resource>
 #include <stdexcept>
+#include <utility>
 
 #include "StringUtils.h"
 
 class Laboratory
 {
 public:
+    // Allocator-aware: all strings are allocated from the given memory resource
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    Laboratory(
+        std::string_view laboratoryId,
+        std::string_view laboratoryName = "",
+        std::string_view organization = "",
+        std::string_view location = "",
+        std::string_view contactName = "",
+        std::string_view contactEmail = "")
+        : Laboratory(std::allocator_arg, allocator_type(),
+                     laboratoryId, laboratoryName, organization, location, contactName, contactEmail)
+    {
+    }
+
     Laboratory(
-        std::string laboratoryId,
-        std::string laboratoryName = "",
-        std::string organization = "",
-        std::string location = "",
-        std::string contactName = "",
-        std::string contactEmail = "")
-        : laboratoryId_(StringUtils::TrimCopy(laboratoryId)),
-          laboratoryName_(std::move(laboratoryName)),
-          organization_(std::move(organization)),
-          location_(std::move(location)),
-          contactName_(std::move(contactName)),
-          contactEmail_(std::move(contactEmail))
+        std::allocator_arg_t,
+        const allocator_type &allocator,
+        std::string_view laboratoryId,
+        std::string_view laboratoryName = "",
+        std::string_view organization = "",
+        std::string_view location = "",
+        std::string_view contactName = "",
+        std::string_view contactEmail = "")
+        : laboratoryId_(StringUtils::TrimView(laboratoryId), allocator),
+          laboratoryName_(laboratoryName, allocator),
+          organization_(organization, allocator),
+          location_(location, allocator),
+          contactName_(contactName, allocator),
+          contactEmail_(contactEmail, allocator)
     {
         Validate();
     }
 
-    const std::string &GetLaboratoryId() const noexcept
+    Laboratory(const Laboratory &) = default;
+    Laboratory(Laboratory &&) noexcept = default;
+    Laboratory &operator=(const Laboratory &) = default;
+    Laboratory &operator=(Laboratory &&) = default;
+
+    Laboratory(std::allocator_arg_t, const allocator_type &allocator, const Laboratory &other)
+        : laboratoryId_(other.laboratoryId_, allocator),
+          laboratoryName_(other.laboratoryName_, allocator),
+          organization_(other.organization_, allocator),
+          location_(other.location_, allocator),
+          contactName_(other.contactName_, allocator),
+          contactEmail_(other.contactEmail_, allocator)
+    {
+    }
+
+    Laboratory(std::allocator_arg_t, const allocator_type &allocator, Laboratory &&other)
+        : laboratoryId_(std::move(other.laboratoryId_), allocator),
+          laboratoryName_(std::move(other.laboratoryName_), allocator),
+          organization_(std::move(other.organization_), allocator),
+          location_(std::move(other.location_), allocator),
+          contactName_(std::move(other.contactName_), allocator),
+          contactEmail_(std::move(other.contactEmail_), allocator)
+    {
+    }
+
+    allocator_type GetAllocator() const noexcept
+    {
+        return laboratoryId_.get_allocator();
+    }
+
+    std::string_view GetLaboratoryId() const noexcept
     {
         return laboratoryId_;
     }
 
-    const std::string &GetLaboratoryName() const noexcept
+    std::string_view GetLaboratoryName() const noexcept
     {
         return laboratoryName_;
     }
 
-    const std::string &GetOrganization() const noexcept
+    std::string_view GetOrganization() const noexcept
     {
         return organization_;
     }
 
-    const std::string &GetLocation() const noexcept
+    std::string_view GetLocation() const noexcept
     {
         return location_;
     }
 
-    const std::string &GetContactName() const noexcept
+    std::string_view GetContactName() const noexcept
     {
         return contactName_;
     }
 
-    const std::string &GetContactEmail() const noexcept
+    std::string_view GetContactEmail() const noexcept
     {
         return contactEmail_;
     }
 
-    void SetLaboratoryName(std::string laboratoryName)
+    void SetLaboratoryName(std::string_view laboratoryName)
     {
-        laboratoryName_ = std::move(laboratoryName);
+        laboratoryName_.assign(laboratoryName);
     }
 
-    void SetContactEmail(std::string contactEmail)
+    void SetContactEmail(std::string_view contactEmail)
     {
-        contactEmail_ = std::move(contactEmail);
+        contactEmail_.assign(contactEmail);
         Validate();
     }
 
 private:
-    std::string laboratoryId_;
-    std::string laboratoryName_;
-    std::string organization_;
-    std::string location_;
-    std::string contactName_;
-    std::string contactEmail_;
+    std::pmr::string laboratoryId_;
+    std::pmr::string laboratoryName_;
+    std::pmr::string organization_;
+    std::pmr::string location_;
+    std::pmr::string contactName_;
+    std::pmr::string contactEmail_;
 
     void Validate() const
     {
@@ -1,43 +1,84 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <memory>
+#include <memory_resource>
 #include <stdexcept>
+#include <utility>
 
 #include "StringUtils.h"
 
 class Measurand
 {
 public:
+    // Allocator-aware: all strings are allocated from the given memory resource
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
     Measurand(
-        std::string measurandId,
-        std::string name,
-        std::string unit,
-        std::string description = "")
-        : measurandId_(StringUtils::TrimCopy(measurandId)),
-          name_(std::move(name)),
-          unit_(std::move(unit)),
-          description_(std::move(description))
+        std::string_view measurandId,
+        std::string_view name,
+        std::string_view unit,
+        std::string_view description = "")
+        : Measurand(std::allocator_arg, allocator_type(), measurandId, name, unit, description)
+    {
+    }
+
+    Measurand(
+        std::allocator_arg_t,
+        const allocator_type &allocator,
+        std::string_view measurandId,
+        std::string_view name,
+        std::string_view unit,
+        std::string_view description = "")
+        : measurandId_(StringUtils::TrimView(measurandId), allocator),
+          name_(name, allocator),
+          unit_(unit, allocator),
+          description_(description, allocator)
     {
         Validate();
     }
 
+    Measurand(const Measurand &) = default;
+    Measurand(Measurand &&) noexcept = default;
+    Measurand &operator=(const Measurand &) = default;
+    Measurand &operator=(Measurand &&) = default;
+
+    Measurand(std::allocator_arg_t, const allocator_type &allocator, const Measurand &other)
+        : measurandId_(other.measurandId_, allocator),
+          name_(other.name_, allocator),
+          unit_(other.unit_, allocator),
+          description_(other.description_, allocator)
+    {
+    }
+
+    Measurand(std::allocator_arg_t, const allocator_type &allocator, Measurand &&other)
+        : measurandId_(std::move(other.measurandId_), allocator),
+          name_(std::move(other.name_), allocator),
+          unit_(std::move(other.unit_), allocator),
+          description_(std::move(other.description_), allocator)
+    {
+    }
+
+    allocator_type GetAllocator() const noexcept { return measurandId_.get_allocator(); }
+
     // Getters
-    const std::string &GetMeasurandId() const noexcept { return measurandId_; }
-    const std::string &GetName() const noexcept { return name_; }
-    const std::string &GetUnit() const noexcept { return unit_; }
-    const std::string &GetDescription() const noexcept { return description_; }
+    std::string_view GetMeasurandId() const noexcept { return measurandId_; }
+    std::string_view GetName() const noexcept { return name_; }
+    std::string_view GetUnit() const noexcept { return unit_; }
+    std::string_view GetDescription() const noexcept { return description_; }
 
     // Optional setters (keep it minimal for now)
-    void SetDescription(std::string description)
+    void SetDescription(std::string_view description)
     {
-        description_ = std::move(description);
+        description_.assign(description);
     }
 
 private:
-    std::string measurandId_;
-    std::string name_;
-    std::string unit_;
-    std::string description_;
+    std::pmr::string measurandId_;
+    std::pmr::string name_;
+    std::pmr::string unit_;
+    std::pmr::string description_;
 
     void Validate() const
     {
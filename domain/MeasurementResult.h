@@ -1,8 +1,12 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <memory>
+#include <memory_resource>
 #include <stdexcept>
 #include <cmath>
+#include <optional>
 #include <utility>
 
 #include "StringUtils.h"
@@ -10,30 +14,81 @@
 class MeasurementResult
 {
 public:
+    // Allocator-aware: all strings are allocated from the given memory resource
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
     MeasurementResult(
-        std::string laboratoryId,
-        std::string sampleId,
+        std::string_view laboratoryId,
+        std::string_view sampleId,
         int replicateIndex,
         double value,
-        std::string timestampIso8601 = "",
-        std::string notes = "")
-        : laboratoryId_(StringUtils::TrimCopy(laboratoryId)),
-          sampleId_(StringUtils::TrimCopy(sampleId)),
+        std::string_view timestampIso8601 = "",
+        std::string_view notes = "",
+        std::optional<double> standardUncertainty = std::nullopt)
+        : MeasurementResult(std::allocator_arg, allocator_type(),
+                            laboratoryId, sampleId, replicateIndex, value, timestampIso8601, notes, standardUncertainty)
+    {
+    }
+
+    MeasurementResult(
+        std::allocator_arg_t,
+        const allocator_type &allocator,
+        std::string_view laboratoryId,
+        std::string_view sampleId,
+        int replicateIndex,
+        double value,
+        std::string_view timestampIso8601 = "",
+        std::string_view notes = "",
+        std::optional<double> standardUncertainty = std::nullopt)
+        : laboratoryId_(StringUtils::TrimView(laboratoryId), allocator),
+          sampleId_(StringUtils::TrimView(sampleId), allocator),
           replicateIndex_(replicateIndex),
           value_(value),
-          timestampIso8601_(std::move(timestampIso8601)),
-          notes_(std::move(notes))
+          standardUncertainty_(standardUncertainty),
+          timestampIso8601_(timestampIso8601, allocator),
+          notes_(notes, allocator)
     {
         Validate();
     }
 
+    MeasurementResult(const MeasurementResult &) = default;
+    MeasurementResult(MeasurementResult &&) noexcept = default;
+    MeasurementResult &operator=(const MeasurementResult &) = default;
+    MeasurementResult &operator=(MeasurementResult &&) = default;
+
+    MeasurementResult(std::allocator_arg_t, const allocator_type &allocator, const MeasurementResult &other)
+        : laboratoryId_(other.laboratoryId_, allocator),
+          sampleId_(other.sampleId_, allocator),
+          replicateIndex_(other.replicateIndex_),
+          value_(other.value_),
+          standardUncertainty_(other.standardUncertainty_),
+          timestampIso8601_(other.timestampIso8601_, allocator),
+          notes_(other.notes_, allocator)
+    {
+    }
+
+    MeasurementResult(std::allocator_arg_t, const allocator_type &allocator, MeasurementResult &&other)
+        : laboratoryId_(std::move(other.laboratoryId_), allocator),
+          sampleId_(std::move(other.sampleId_), allocator),
+          replicateIndex_(other.replicateIndex_),
+          value_(other.value_),
+          standardUncertainty_(other.standardUncertainty_),
+          timestampIso8601_(std::move(other.timestampIso8601_), allocator),
+          notes_(std::move(other.notes_), allocator)
+    {
+    }
+
+    allocator_type GetAllocator() const noexcept { return laboratoryId_.get_allocator(); }
+
     // Getters
-    const std::string &GetLaboratoryId() const noexcept { return laboratoryId_; }
-    const std::string &GetSampleId() const noexcept { return sampleId_; }
+    std::string_view GetLaboratoryId() const noexcept { return laboratoryId_; }
+    std::string_view GetSampleId() const noexcept { return sampleId_; }
     int GetReplicateIndex() const noexcept { return replicateIndex_; }
     double GetValue() const noexcept { return value_; }
-    const std::string &GetTimestampIso8601() const noexcept { return timestampIso8601_; }
-    const std::string &GetNotes() const noexcept { return notes_; }
+    // Standard uncertainty reported by the laboratory for this value, if any
+    const std::optional<double> &GetStandardUncertainty() const noexcept { return standardUncertainty_; }
+    std::string_view GetTimestampIso8601() const noexcept { return timestampIso8601_; }
+    std::string_view GetNotes() const noexcept { return notes_; }
 
     // Optional setters (minimal)
     void SetValue(double value)
@@ -42,18 +97,25 @@ public:
         Validate();
     }
 
-    void SetNotes(std::string notes)
+    void SetStandardUncertainty(std::optional<double> standardUncertainty)
     {
-        notes_ = std::move(notes);
+        standardUncertainty_ = standardUncertainty;
+        Validate();
+    }
+
+    void SetNotes(std::string_view notes)
+    {
+        notes_.assign(notes);
     }
 
 private:
-    std::string laboratoryId_;
-    std::string sampleId_;
+    std::pmr::string laboratoryId_;
+    std::pmr::string sampleId_;
     int replicateIndex_;
     double value_;
-    std::string timestampIso8601_;
-    std::string notes_;
+    std::optional<double> standardUncertainty_;
+    std::pmr::string timestampIso8601_;
+    std::pmr::string notes_;
 
     void Validate() const
     {
@@ -76,5 +138,11 @@ private:
         {
             throw std::invalid_argument("Value must be a finite number (not NaN/Inf).");
         }
+
+        if (standardUncertainty_.has_value() &&
+            (!std::isfinite(standardUncertainty_.value()) || standardUncertainty_.value() < 0.0))
+        {
+            throw std::invalid_argument("StandardUncertainty must be a finite number >= 0.");
+        }
     }
 };
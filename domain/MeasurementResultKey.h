@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <cstddef>
+#include <functional>
+
+// Identity of a MeasurementResult inside a Study: (LaboratoryId, SampleId, ReplicateIndex)
+struct MeasurementResultKey
+{
+    std::string laboratoryId;
+    std::string sampleId;
+    int replicateIndex = 0;
+
+    bool operator==(const MeasurementResultKey &other) const noexcept
+    {
+        return replicateIndex == other.replicateIndex &&
+               laboratoryId == other.laboratoryId &&
+               sampleId == other.sampleId;
+    }
+
+    bool operator<(const MeasurementResultKey &other) const noexcept
+    {
+        return std::tie(laboratoryId, sampleId, replicateIndex) <
+               std::tie(other.laboratoryId, other.sampleId, other.replicateIndex);
+    }
+};
+
+// Non-owning variant of MeasurementResultKey; the viewed strings must outlive it
+struct MeasurementResultKeyView
+{
+    std::string_view laboratoryId;
+    std::string_view sampleId;
+    int replicateIndex = 0;
+
+    bool operator==(const MeasurementResultKeyView &other) const noexcept
+    {
+        return replicateIndex == other.replicateIndex &&
+               laboratoryId == other.laboratoryId &&
+               sampleId == other.sampleId;
+    }
+};
+
+struct MeasurementResultKeyHash
+{
+    // Hash of the (LaboratoryId, SampleId) pair only; all replicates of a pair share it
+    static std::size_t HashPair(std::string_view laboratoryId, std::string_view sampleId) noexcept
+    {
+        const std::size_t labHash = std::hash<std::string_view>{}(laboratoryId);
+        const std::size_t sampleHash = std::hash<std::string_view>{}(sampleId);
+        return labHash ^ (sampleHash + 0x9e3779b97f4a7c15ULL + (labHash << 6) + (labHash >> 2));
+    }
+
+    static std::size_t Hash(std::string_view laboratoryId, std::string_view sampleId, int replicateIndex) noexcept
+    {
+        const std::size_t pairHash = HashPair(laboratoryId, sampleId);
+        return pairHash ^ (std::hash<int>{}(replicateIndex) + 0x9e3779b97f4a7c15ULL + (pairHash << 6) + (pairHash >> 2));
+    }
+
+    std::size_t operator()(const MeasurementResultKey &key) const noexcept
+    {
+        return Hash(key.laboratoryId, key.sampleId, key.replicateIndex);
+    }
+
+    std::size_t operator()(const MeasurementResultKeyView &key) const noexcept
+    {
+        return Hash(key.laboratoryId, key.sampleId, key.replicateIndex);
+    }
+};
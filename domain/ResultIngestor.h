@@ -0,0 +1,155 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <stdexcept>
+#include <algorithm>
+#include <tuple>
+#include <unordered_set>
+
+#include "MeasurementResult.h"
+#include "MeasurementResultKey.h"
+#include "Study.h"
+
+// Concurrent front-end for bulk result import.
+//
+// Producer threads call Submit() in parallel; results are sharded by
+// (LaboratoryId, SampleId) so that all replicates of one pair land in the same
+// shard and duplicate keys are detected under a single shard lock.
+// CommitTo() merges all shards into a Study in key order, so the final
+// result order does not depend on thread scheduling.
+class ResultIngestor
+{
+public:
+    // shardCount == 0 picks a default based on the hardware thread count
+    explicit ResultIngestor(std::size_t shardCount = 0)
+    {
+        if (shardCount == 0)
+        {
+            const std::size_t threads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+            shardCount = threads * 4;
+        }
+
+        shards_.reserve(shardCount);
+        for (std::size_t index = 0; index < shardCount; ++index)
+        {
+            shards_.push_back(std::make_unique<Shard>());
+        }
+    }
+
+    ResultIngestor(const ResultIngestor &) = delete;
+    ResultIngestor &operator=(const ResultIngestor &) = delete;
+
+    // Thread-safe. Throws if the same (LaboratoryId, SampleId, ReplicateIndex)
+    // has already been submitted since the last commit.
+    void Submit(MeasurementResult result)
+    {
+        Shard &shard = ShardFor(result.GetLaboratoryId(), result.GetSampleId());
+        MeasurementResultKey key{
+            std::string(result.GetLaboratoryId()), std::string(result.GetSampleId()), result.GetReplicateIndex()};
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (!shard.keys.insert(std::move(key)).second)
+        {
+            throw std::invalid_argument(
+                "ResultIngestor::Submit: Duplicate (LaboratoryId, SampleId, ReplicateIndex).");
+        }
+
+        shard.results.push_back(std::move(result));
+    }
+
+    // Thread-safe
+    std::size_t GetPendingCount() const
+    {
+        std::size_t count = 0;
+        for (const auto &shard : shards_)
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            count += shard->results.size();
+        }
+        return count;
+    }
+
+    // Merges all pending results into the study in one all-or-nothing step.
+    // Must not run concurrently with Submit(). On success the ingestor is
+    // empty; when the study rejects any result (unknown laboratory or sample,
+    // key already in the study) nothing is added, the exception propagates and
+    // all pending results stay in the ingestor.
+    void CommitTo(Study &study)
+    {
+        std::vector<MeasurementResult> merged;
+        merged.reserve(GetPendingCount());
+        for (auto &shard : shards_)
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            merged.insert(merged.end(),
+                          std::make_move_iterator(shard->results.begin()),
+                          std::make_move_iterator(shard->results.end()));
+            shard->results.clear();
+        }
+
+        std::sort(merged.begin(), merged.end(),
+                  [](const MeasurementResult &a, const MeasurementResult &b)
+                  {
+                      return std::make_tuple(a.GetLaboratoryId(), a.GetSampleId(), a.GetReplicateIndex()) <
+                             std::make_tuple(b.GetLaboratoryId(), b.GetSampleId(), b.GetReplicateIndex());
+                  });
+
+        try
+        {
+            study.AddMeasurementResults(std::move(merged));
+        }
+        catch (...)
+        {
+            // The study left `merged` untouched; hand every result back to its
+            // shard. The keys were never cleared and the shard vectors kept
+            // their capacity, so this cannot fail.
+            for (auto &result : merged)
+            {
+                Shard &shard = ShardFor(result.GetLaboratoryId(), result.GetSampleId());
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                shard.results.push_back(std::move(result));
+            }
+            throw;
+        }
+
+        for (auto &shard : shards_)
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->keys.clear();
+        }
+    }
+
+    // Discards all pending results
+    void Clear()
+    {
+        for (auto &shard : shards_)
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->results.clear();
+            shard->keys.clear();
+        }
+    }
+
+private:
+    // Aligned to a cache line so neighbouring shard locks do not false-share
+    struct alignas(64) Shard
+    {
+        mutable std::mutex mutex;
+        std::vector<MeasurementResult> results;
+        std::unordered_set<MeasurementResultKey, MeasurementResultKeyHash> keys;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    Shard &ShardFor(std::string_view laboratoryId, std::string_view sampleId)
+    {
+        const std::size_t hash = MeasurementResultKeyHash::HashPair(laboratoryId, sampleId);
+        return *shards_[hash % shards_.size()];
+    }
+};
@@ -0,0 +1,401 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <limits>
+#include <cmath>
+#include <optional>
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include "Study.h"
+#include "Reduction.h"
+
+// One result joined to the laboratory, sample and measurand it refers to
+struct ResultRow
+{
+    const MeasurementResult &result;
+    const Laboratory &laboratory;
+    const Sample &sample;
+    const Measurand &measurand;
+};
+
+// Single-pass summary statistics: compensated summation for the sum and
+// mean, Welford's algorithm for the variance
+struct ResultStatistics
+{
+    std::size_t count = 0;
+    double min = std::numeric_limits<double>::quiet_NaN();
+    double max = std::numeric_limits<double>::quiet_NaN();
+
+    void Add(double value) noexcept
+    {
+        ++count;
+        sum_.Add(value);
+
+        const double delta = value - runningMean_;
+        runningMean_ += delta / static_cast<double>(count);
+        m2_ += delta * (value - runningMean_);
+
+        if (count == 1 || value < min)
+        {
+            min = value;
+        }
+        if (count == 1 || value > max)
+        {
+            max = value;
+        }
+    }
+
+    double GetSum() const noexcept
+    {
+        return sum_.GetSum();
+    }
+
+    // NaN when empty
+    double GetMean() const noexcept
+    {
+        return count > 0 ? GetSum() / static_cast<double>(count) : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    // Sample variance (n - 1); NaN for fewer than two values
+    double GetVariance() const noexcept
+    {
+        return count > 1 ? m2_ / static_cast<double>(count - 1) : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    double GetStandardDeviation() const noexcept
+    {
+        return std::sqrt(GetVariance());
+    }
+
+private:
+    Reduction::CompensatedSum sum_;
+
+    // Welford's running mean and sum of squared deviations, for the variance only
+    double runningMean_ = 0.0;
+    double m2_ = 0.0;
+};
+
+template <typename Key>
+class GroupedResultQuery;
+
+// Lazy, composable query over the results of a Study.
+//
+// Each Where* call returns a new query; nothing is evaluated until a terminal
+// operation (ForEach, Count, Aggregate, Mean, ...) runs. Predicates on the
+// laboratory, sample and measurand are evaluated once per entity, not once
+// per result, and id equality filters are checked directly on the result key
+// before any join lookup. All terminals make a single fused pass over the
+// results without building intermediate vectors.
+//
+// The study must outlive the query and must not be modified while it runs.
+class ResultQuery
+{
+public:
+    using LaboratoryPredicate = std::function<bool(const Laboratory &)>;
+    using SamplePredicate = std::function<bool(const Sample &)>;
+    using MeasurandPredicate = std::function<bool(const Measurand &)>;
+    using RowPredicate = std::function<bool(const ResultRow &)>;
+    using ValueSelector = std::function<double(const ResultRow &)>;
+
+    explicit ResultQuery(const Study &study)
+        : study_(&study)
+    {
+    }
+
+    // -------------------------
+    // Filters
+    // -------------------------
+    ResultQuery WhereLaboratory(LaboratoryPredicate predicate) const
+    {
+        ResultQuery query = *this;
+        query.laboratoryPredicates_.push_back(std::move(predicate));
+        return query;
+    }
+
+    ResultQuery WhereSample(SamplePredicate predicate) const
+    {
+        ResultQuery query = *this;
+        query.samplePredicates_.push_back(std::move(predicate));
+        return query;
+    }
+
+    ResultQuery WhereMeasurand(MeasurandPredicate predicate) const
+    {
+        ResultQuery query = *this;
+        query.measurandPredicates_.push_back(std::move(predicate));
+        return query;
+    }
+
+    ResultQuery Where(RowPredicate predicate) const
+    {
+        ResultQuery query = *this;
+        query.rowPredicates_.push_back(std::move(predicate));
+        return query;
+    }
+
+    ResultQuery WhereLaboratoryId(std::string_view laboratoryId) const
+    {
+        ResultQuery query = *this;
+        query.AddIdFilter(query.laboratoryId_, laboratoryId);
+        return query;
+    }
+
+    ResultQuery WhereSampleId(std::string_view sampleId) const
+    {
+        ResultQuery query = *this;
+        query.AddIdFilter(query.sampleId_, sampleId);
+        return query;
+    }
+
+    ResultQuery WhereMeasurandId(std::string_view measurandId) const
+    {
+        return WhereMeasurand([id = std::string(StringUtils::TrimView(measurandId))](const Measurand &measurand)
+                              { return std::string_view(measurand.GetMeasurandId()) == id; });
+    }
+
+    ResultQuery WhereReplicate(int replicateIndex) const
+    {
+        ResultQuery query = *this;
+        if (query.replicateIndex_.has_value() && query.replicateIndex_.value() != replicateIndex)
+        {
+            query.empty_ = true;
+        }
+        query.replicateIndex_ = replicateIndex;
+        return query;
+    }
+
+    // Aggregates use this value instead of MeasurementResult::GetValue()
+    ResultQuery Select(ValueSelector selector) const
+    {
+        ResultQuery query = *this;
+        query.selector_ = std::move(selector);
+        return query;
+    }
+
+    template <typename KeyFn>
+    GroupedResultQuery<std::decay_t<std::invoke_result_t<KeyFn, const ResultRow &>>> GroupBy(KeyFn keyFn) const;
+
+    // -------------------------
+    // Terminals
+    // -------------------------
+    template <typename Fn>
+    void ForEach(Fn &&fn) const
+    {
+        Execute(std::forward<Fn>(fn));
+    }
+
+    std::size_t Count() const
+    {
+        std::size_t count = 0;
+        Execute([&](const ResultRow &)
+                { ++count; });
+        return count;
+    }
+
+    ResultStatistics Aggregate() const
+    {
+        ResultStatistics statistics;
+        Execute([&](const ResultRow &row)
+                { statistics.Add(SelectValue(row)); });
+        return statistics;
+    }
+
+    // NaN when no result matches
+    double Mean() const
+    {
+        return Aggregate().GetMean();
+    }
+
+    double Sum() const { return Aggregate().GetSum(); }
+    double Min() const { return Aggregate().min; }
+    double Max() const { return Aggregate().max; }
+    double StandardDeviation() const { return Aggregate().GetStandardDeviation(); }
+
+    double SelectValue(const ResultRow &row) const
+    {
+        return selector_ ? selector_(row) : row.result.GetValue();
+    }
+
+private:
+    const Study *study_;
+
+    std::vector<LaboratoryPredicate> laboratoryPredicates_;
+    std::vector<SamplePredicate> samplePredicates_;
+    std::vector<MeasurandPredicate> measurandPredicates_;
+    std::vector<RowPredicate> rowPredicates_;
+    std::optional<std::string> laboratoryId_;
+    std::optional<std::string> sampleId_;
+    std::optional<int> replicateIndex_;
+    ValueSelector selector_;
+
+    // Set when two filters contradict each other
+    bool empty_ = false;
+
+    void AddIdFilter(std::optional<std::string> &filter, std::string_view id)
+    {
+        const std::string_view trimmed = StringUtils::TrimView(id);
+        if (filter.has_value() && filter.value() != trimmed)
+        {
+            empty_ = true;
+        }
+        filter = std::string(trimmed);
+    }
+
+    template <typename Fn>
+    void Execute(Fn &&fn) const
+    {
+        if (empty_)
+        {
+            return;
+        }
+
+        // Measurands: evaluate predicates once per measurand
+        std::unordered_map<std::string_view, std::pair<const Measurand *, bool>> measurands;
+        measurands.reserve(study_->GetMeasurandCount());
+        study_->ForEachMeasurand([&](const Measurand &measurand)
+                                 { measurands.emplace(measurand.GetMeasurandId(), std::make_pair(&measurand, AllOf(measurandPredicates_, measurand))); });
+
+        // Samples: only those passing their own and their measurand's predicates are kept
+        std::unordered_map<std::string_view, std::pair<const Sample *, const Measurand *>> samples;
+        samples.reserve(study_->GetSampleCount());
+        study_->ForEachSample([&](const Sample &sample)
+                              {
+                                  if (sampleId_.has_value() && std::string_view(sample.GetSampleId()) != sampleId_.value())
+                                  {
+                                      return;
+                                  }
+                                  const auto measurand = measurands.find(sample.GetMeasurandId());
+                                  if (measurand != measurands.end() && measurand->second.second && AllOf(samplePredicates_, sample))
+                                  {
+                                      samples.emplace(sample.GetSampleId(), std::make_pair(&sample, measurand->second.first));
+                                  }
+                              });
+
+        std::unordered_map<std::string_view, const Laboratory *> laboratories;
+        laboratories.reserve(study_->GetLaboratoryCount());
+        study_->ForEachLaboratory([&](const Laboratory &laboratory)
+                                  {
+                                      if (laboratoryId_.has_value() && std::string_view(laboratory.GetLaboratoryId()) != laboratoryId_.value())
+                                      {
+                                          return;
+                                      }
+                                      if (AllOf(laboratoryPredicates_, laboratory))
+                                      {
+                                          laboratories.emplace(laboratory.GetLaboratoryId(), &laboratory);
+                                      }
+                                  });
+
+        if (samples.empty() || laboratories.empty())
+        {
+            return;
+        }
+
+        study_->ForEachMeasurementResult([&](const MeasurementResult &result)
+                                         {
+                                             // Cheapest checks first: plain key comparisons, then the join lookups
+                                             if (replicateIndex_.has_value() && result.GetReplicateIndex() != replicateIndex_.value())
+                                             {
+                                                 return;
+                                             }
+                                             if (sampleId_.has_value() && std::string_view(result.GetSampleId()) != sampleId_.value())
+                                             {
+                                                 return;
+                                             }
+                                             if (laboratoryId_.has_value() && std::string_view(result.GetLaboratoryId()) != laboratoryId_.value())
+                                             {
+                                                 return;
+                                             }
+
+                                             const auto sample = samples.find(result.GetSampleId());
+                                             if (sample == samples.end())
+                                             {
+                                                 return;
+                                             }
+                                             const auto laboratory = laboratories.find(result.GetLaboratoryId());
+                                             if (laboratory == laboratories.end())
+                                             {
+                                                 return;
+                                             }
+
+                                             const ResultRow row{result, *laboratory->second, *sample->second.first, *sample->second.second};
+                                             if (AllOf(rowPredicates_, row))
+                                             {
+                                                 fn(row);
+                                             }
+                                         });
+    }
+
+    template <typename Predicate, typename Value>
+    static bool AllOf(const std::vector<Predicate> &predicates, const Value &value)
+    {
+        for (const auto &predicate : predicates)
+        {
+            if (!predicate(value))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename Key>
+    friend class GroupedResultQuery;
+};
+
+// A ResultQuery partitioned by a key computed from each row.
+// Groups are returned in ascending key order, so Key must be less-than comparable.
+template <typename Key>
+class GroupedResultQuery
+{
+public:
+    using KeyFunction = std::function<Key(const ResultRow &)>;
+
+    GroupedResultQuery(ResultQuery query, KeyFunction keyFn)
+        : query_(std::move(query)),
+          keyFn_(std::move(keyFn))
+    {
+    }
+
+    std::map<Key, ResultStatistics> Aggregate() const
+    {
+        std::map<Key, ResultStatistics> groups;
+        query_.Execute([&](const ResultRow &row)
+                       { groups[keyFn_(row)].Add(query_.SelectValue(row)); });
+        return groups;
+    }
+
+    std::map<Key, std::size_t> Count() const
+    {
+        std::map<Key, std::size_t> groups;
+        query_.Execute([&](const ResultRow &row)
+                       { ++groups[keyFn_(row)]; });
+        return groups;
+    }
+
+    std::map<Key, double> Mean() const
+    {
+        std::map<Key, double> means;
+        for (const auto &[key, statistics] : Aggregate())
+        {
+            means.emplace(key, statistics.GetMean());
+        }
+        return means;
+    }
+
+private:
+    ResultQuery query_;
+    KeyFunction keyFn_;
+};
+
+template <typename KeyFn>
+GroupedResultQuery<std::decay_t<std::invoke_result_t<KeyFn, const ResultRow &>>> ResultQuery::GroupBy(KeyFn keyFn) const
+{
+    using Key = std::decay_t<std::invoke_result_t<KeyFn, const ResultRow &>>;
+    return GroupedResultQuery<Key>(*this, std::move(keyFn));
+}
@@ -1,37 +1,82 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <memory>
+#include <memory_resource>
 #include <stdexcept>
 #include <optional>
+#include <utility>
 
 #include "StringUtils.h"
 
 class Sample
 {
 public:
+    // Allocator-aware: all strings are allocated from the given memory resource
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    Sample(
+        std::string_view sampleId,
+        std::string_view measurandId,
+        std::optional<double> assignedValue = std::nullopt,
+        std::optional<double> standardUncertainty = std::nullopt,
+        std::string_view description = "")
+        : Sample(std::allocator_arg, allocator_type(),
+                 sampleId, measurandId, assignedValue, standardUncertainty, description)
+    {
+    }
+
     Sample(
-        std::string sampleId,
-        std::string measurandId,
+        std::allocator_arg_t,
+        const allocator_type &allocator,
+        std::string_view sampleId,
+        std::string_view measurandId,
         std::optional<double> assignedValue = std::nullopt,
         std::optional<double> standardUncertainty = std::nullopt,
-        std::string description = "")
-        : sampleId_(StringUtils::TrimCopy(sampleId)),
-          measurandId_(StringUtils::TrimCopy(measurandId)),
+        std::string_view description = "")
+        : sampleId_(StringUtils::TrimView(sampleId), allocator),
+          measurandId_(StringUtils::TrimView(measurandId), allocator),
           assignedValue_(assignedValue),
           standardUncertainty_(standardUncertainty),
-          description_(std::move(description))
+          description_(description, allocator)
     {
         Validate();
     }
 
+    Sample(const Sample &) = default;
+    Sample(Sample &&) noexcept = default;
+    Sample &operator=(const Sample &) = default;
+    Sample &operator=(Sample &&) = default;
+
+    Sample(std::allocator_arg_t, const allocator_type &allocator, const Sample &other)
+        : sampleId_(other.sampleId_, allocator),
+          measurandId_(other.measurandId_, allocator),
+          assignedValue_(other.assignedValue_),
+          standardUncertainty_(other.standardUncertainty_),
+          description_(other.description_, allocator)
+    {
+    }
+
+    Sample(std::allocator_arg_t, const allocator_type &allocator, Sample &&other)
+        : sampleId_(std::move(other.sampleId_), allocator),
+          measurandId_(std::move(other.measurandId_), allocator),
+          assignedValue_(other.assignedValue_),
+          standardUncertainty_(other.standardUncertainty_),
+          description_(std::move(other.description_), allocator)
+    {
+    }
+
+    allocator_type GetAllocator() const noexcept { return sampleId_.get_allocator(); }
+
     // Getters
-    const std::string &GetSampleId() const noexcept { return sampleId_; }
-    const std::string &GetMeasurandId() const noexcept { return measurandId_; }
+    std::string_view GetSampleId() const noexcept { return sampleId_; }
+    std::string_view GetMeasurandId() const noexcept { return measurandId_; }
 
     const std::optional<double> &GetAssignedValue() const noexcept { return assignedValue_; }
     const std::optional<double> &GetStandardUncertainty() const noexcept { return standardUncertainty_; }
 
-    const std::string &GetDescription() const noexcept { return description_; }
+    std::string_view GetDescription() const noexcept { return description_; }
 
     // Setters (minimal)
     void SetAssignedValue(std::optional<double> assignedValue)
@@ -47,11 +92,11 @@ public:
     }
 
 private:
-    std::string sampleId_;
-    std::string measurandId_;
+    std::pmr::string sampleId_;
+    std::pmr::string measurandId_;
     std::optional<double> assignedValue_;
     std::optional<double> standardUncertainty_;
-    std::string description_;
+    std::pmr::string description_;
 
     void Validate() const
     {
@@ -1,47 +1,132 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <memory>
+#include <memory_resource>
 #include <stdexcept>
 #include <algorithm>
+#include <iterator>
+#include <utility>
+#include <optional>
+#include <limits>
+#include <cstdint>
+#include <unordered_set>
 
 #include "StringUtils.h"
+#include "DateTimeUtils.h"
 #include "Laboratory.h"
 #include "Measurand.h"
 #include "Sample.h"
 #include "MeasurementResult.h"
+#include "MeasurementResultKey.h"
+#include "StudyChange.h"
 
 class Study
 {
 public:
-    Study(std::string studyId, std::string title = "")
-        : studyId_(StringUtils::TrimCopy(studyId)),
-          title_(std::move(title))
+    // Allocator-aware: the study and every object it stores allocate from the
+    // given memory resource, e.g. a std::pmr::monotonic_buffer_resource that
+    // holds a whole round and is released in one shot.
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    Study(std::string_view studyId, std::string_view title = "")
+        : Study(std::allocator_arg, allocator_type(), studyId, title)
+    {
+    }
+
+    Study(std::allocator_arg_t, const allocator_type &allocator, std::string_view studyId, std::string_view title = "")
+        : studyId_(StringUtils::TrimView(studyId), allocator),
+          title_(title, allocator),
+          startDateIso8601_(allocator),
+          endDateIso8601_(allocator),
+          laboratories_(allocator),
+          measurands_(allocator),
+          samples_(allocator),
+          results_(allocator),
+          timeIndex_(allocator)
     {
         Validate();
     }
 
+    allocator_type GetAllocator() const noexcept { return studyId_.get_allocator(); }
+
+    // -------------------------
+    // Change notification
+    // -------------------------
+    using Subscriber = StudyChangeNotifier::Subscriber;
+    using SubscriptionId = StudyChangeNotifier::SubscriptionId;
+
+    // Every successful mutation is reported to the subscribers as StudyChange
+    // records; failed or no-op calls report nothing. Subscribing does not
+    // change the study's contents, so it is allowed on a const Study.
+    // Subscriptions stay with this object: copies and moves of the study do
+    // not take them along, and assigning to the study reports one Reset.
+    SubscriptionId Subscribe(Subscriber subscriber) const
+    {
+        return notifier_.Subscribe(std::move(subscriber));
+    }
+
+    bool Unsubscribe(SubscriptionId id) const
+    {
+        return notifier_.Unsubscribe(id);
+    }
+
+    // Collects changes until the matching EndBatch and publishes them once,
+    // coalesced per entity. Batches nest. See also StudyChangeBatch.
+    void BeginBatch() noexcept
+    {
+        notifier_.BeginBatch();
+    }
+
+    void EndBatch()
+    {
+        notifier_.EndBatch();
+    }
+
     // -------------------------
     // Basic getters / setters
     // -------------------------
-    const std::string &GetStudyId() const noexcept { return studyId_; }
-    const std::string &GetTitle() const noexcept { return title_; }
-    const std::string &GetStartDateIso8601() const noexcept { return startDateIso8601_; }
-    const std::string &GetEndDateIso8601() const noexcept { return endDateIso8601_; }
+    std::string_view GetStudyId() const noexcept { return studyId_; }
+    std::string_view GetTitle() const noexcept { return title_; }
+    std::string_view GetStartDateIso8601() const noexcept { return startDateIso8601_; }
+    std::string_view GetEndDateIso8601() const noexcept { return endDateIso8601_; }
 
-    void SetTitle(std::string title)
+    void SetTitle(std::string_view title)
     {
-        title_ = std::move(title);
+        std::string oldValue;
+        if (notifier_.HasSubscribers())
+        {
+            oldValue.assign(title_);
+        }
+
+        title_.assign(title);
+        NotifyPropertyChanged("Title", std::move(oldValue), title_);
     }
 
-    void SetStartDateIso8601(std::string startDateIso8601)
+    void SetStartDateIso8601(std::string_view startDateIso8601)
     {
-        startDateIso8601_ = std::move(startDateIso8601);
+        std::string oldValue;
+        if (notifier_.HasSubscribers())
+        {
+            oldValue.assign(startDateIso8601_);
+        }
+
+        startDateIso8601_.assign(startDateIso8601);
+        NotifyPropertyChanged("StartDateIso8601", std::move(oldValue), startDateIso8601_);
     }
 
-    void SetEndDateIso8601(std::string endDateIso8601)
+    void SetEndDateIso8601(std::string_view endDateIso8601)
     {
-        endDateIso8601_ = std::move(endDateIso8601);
+        std::string oldValue;
+        if (notifier_.HasSubscribers())
+        {
+            oldValue.assign(endDateIso8601_);
+        }
+
+        endDateIso8601_.assign(endDateIso8601);
+        NotifyPropertyChanged("EndDateIso8601", std::move(oldValue), endDateIso8601_);
     }
 
     // --------------------------------
@@ -49,7 +134,7 @@ public:
     // --------------------------------
     void AddLaboratory(const Laboratory &laboratory)
     {
-        const std::string laboratoryId = StringUtils::TrimCopy(laboratory.GetLaboratoryId());
+        const std::string_view laboratoryId = StringUtils::TrimView(laboratory.GetLaboratoryId());
         if (laboratoryId.empty())
         {
             throw std::invalid_argument("AddLaboratory: LaboratoryId must not be empty.");
@@ -61,18 +146,34 @@ public:
         }
 
         laboratories_.push_back(laboratory);
+        NotifyAdded(StudyEntity::Laboratory, laboratories_.back());
+    }
+
+    // Constructs the laboratory in place from Laboratory constructor arguments
+    template <typename... Args>
+    const Laboratory &EmplaceLaboratory(Args &&...args)
+    {
+        laboratories_.emplace_back(std::forward<Args>(args)...);
+        if (FindLaboratoryIndexById(laboratories_.back().GetLaboratoryId()).value() != laboratories_.size() - 1)
+        {
+            laboratories_.pop_back();
+            throw std::invalid_argument("EmplaceLaboratory: Duplicate LaboratoryId.");
+        }
+
+        NotifyAdded(StudyEntity::Laboratory, laboratories_.back());
+        return laboratories_.back();
     }
 
-    bool UpdateLaboratory(const std::string &laboratoryId, const Laboratory &newLaboratory)
+    bool UpdateLaboratory(std::string_view laboratoryId, const Laboratory &newLaboratory)
     {
-        const std::string trimmedId = StringUtils::TrimCopy(laboratoryId);
+        const std::string_view trimmedId = StringUtils::TrimView(laboratoryId);
         const auto indexOpt = FindLaboratoryIndexById(trimmedId);
         if (!indexOpt.has_value())
         {
             return false;
         }
 
-        const std::string newId = StringUtils::TrimCopy(newLaboratory.GetLaboratoryId());
+        const std::string_view newId = StringUtils::TrimView(newLaboratory.GetLaboratoryId());
         if (newId.empty())
         {
             throw std::invalid_argument("UpdateLaboratory: New LaboratoryId must not be empty.");
@@ -84,22 +185,29 @@ public:
             throw std::invalid_argument("UpdateLaboratory: New LaboratoryId already exists.");
         }
 
-        laboratories_[indexOpt.value()] = newLaboratory;
-
         // If ID changed, results that reference the old id become inconsistent.
         // For now: forbid changing ID when there are results for that laboratory.
+        // Checked before assigning, since laboratoryId may view into the stored laboratory.
         if (newId != trimmedId && HasResultsForLaboratory(trimmedId))
         {
             throw std::invalid_argument(
                 "UpdateLaboratory: Cannot change LaboratoryId while results exist for it.");
         }
 
+        std::optional<Laboratory> oldValue;
+        if (notifier_.HasSubscribers())
+        {
+            oldValue.emplace(laboratories_[indexOpt.value()]);
+        }
+
+        laboratories_[indexOpt.value()] = newLaboratory;
+        NotifyUpdated(StudyEntity::Laboratory, std::move(oldValue), laboratories_[indexOpt.value()]);
         return true;
     }
 
-    bool RemoveLaboratoryById(const std::string &laboratoryId)
+    bool RemoveLaboratoryById(std::string_view laboratoryId)
     {
-        const std::string trimmedId = StringUtils::TrimCopy(laboratoryId);
+        const std::string_view trimmedId = StringUtils::TrimView(laboratoryId);
         const auto indexOpt = FindLaboratoryIndexById(trimmedId);
         if (!indexOpt.has_value())
         {
@@ -111,13 +219,20 @@ public:
             throw std::invalid_argument("RemoveLaboratoryById: Laboratory has results.");
         }
 
+        std::optional<Laboratory> oldValue;
+        if (notifier_.HasSubscribers())
+        {
+            oldValue.emplace(std::move(laboratories_[indexOpt.value()]));
+        }
+
         laboratories_.erase(laboratories_.begin() + indexOpt.value());
+        NotifyRemoved(StudyEntity::Laboratory, std::move(oldValue));
         return true;
     }
 
-    const Laboratory &GetLaboratoryById(const std::string &laboratoryId) const
+    const Laboratory &GetLaboratoryById(std::string_view laboratoryId) const
     {
-        const std::string trimmedId = StringUtils::TrimCopy(laboratoryId);
+        const std::string_view trimmedId = StringUtils::TrimView(laboratoryId);
         const auto indexOpt = FindLaboratoryIndexById(trimmedId);
         if (!indexOpt.has_value())
         {
@@ -129,7 +244,22 @@ public:
 
     std::vector<Laboratory> GetLaboratories() const
     {
-        return laboratories_;
+        return std::vector<Laboratory>(laboratories_.begin(), laboratories_.end());
+    }
+
+    std::size_t GetLaboratoryCount() const noexcept
+    {
+        return laboratories_.size();
+    }
+
+    // Visits every laboratory in storage order without copying
+    template <typename Fn>
+    void ForEachLaboratory(Fn &&fn) const
+    {
+        for (const auto &laboratory : laboratories_)
+        {
+            fn(laboratory);
+        }
     }
 
     // --------------------------------
@@ -137,7 +267,7 @@ public:
     // --------------------------------
     void AddMeasurand(const Measurand &measurand)
     {
-        const std::string measurandId = StringUtils::TrimCopy(measurand.GetMeasurandId());
+        const std::string_view measurandId = StringUtils::TrimView(measurand.GetMeasurandId());
         if (measurandId.empty())
         {
             throw std::invalid_argument("AddMeasurand: MeasurandId must not be empty.");
@@ -149,18 +279,34 @@ public:
         }
 
         measurands_.push_back(measurand);
+        NotifyAdded(StudyEntity::Measurand, measurands_.back());
     }
 
-    bool UpdateMeasurand(const std::string &measurandId, const Measurand &newMeasurand)
+    // Constructs the measurand in place from Measurand constructor arguments
+    template <typename... Args>
+    const Measurand &EmplaceMeasurand(Args &&...args)
     {
-        const std::string trimmedId = StringUtils::TrimCopy(measurandId);
+        measurands_.emplace_back(std::forward<Args>(args)...);
+        if (FindMeasurandIndexById(measurands_.back().GetMeasurandId()).value() != measurands_.size() - 1)
+        {
+            measurands_.pop_back();
+            throw std::invalid_argument("EmplaceMeasurand: Duplicate MeasurandId.");
+        }
+
+        NotifyAdded(StudyEntity::Measurand, measurands_.back());
+        return measurands_.back();
+    }
+
+    bool UpdateMeasurand(std::string_view measurandId, const Measurand &newMeasurand)
+    {
+        const std::string_view trimmedId = StringUtils::TrimView(measurandId);
         const auto indexOpt = FindMeasurandIndexById(trimmedId);
         if (!indexOpt.has_value())
         {
             return false;
         }
 
-        const std::string newId = StringUtils::TrimCopy(newMeasurand.GetMeasurandId());
+        const std::string_view newId = StringUtils::TrimView(newMeasurand.GetMeasurandId());
         if (newId.empty())
         {
             throw std::invalid_argument("UpdateMeasurand: New MeasurandId must not be empty.");
@@ -178,13 +324,20 @@ public:
                 "UpdateMeasurand: Cannot change MeasurandId while Samples reference it.");
         }
 
+        std::optional<Measurand> oldValue;
+        if (notifier_.HasSubscribers())
+        {
+            oldValue.emplace(measurands_[indexOpt.value()]);
+        }
+
         measurands_[indexOpt.value()] = newMeasurand;
+        NotifyUpdated(StudyEntity::Measurand, std::move(oldValue), measurands_[indexOpt.value()]);
         return true;
     }
 
-    bool RemoveMeasurandById(const std::string &measurandId)
+    bool RemoveMeasurandById(std::string_view measurandId)
     {
-        const std::string trimmedId = StringUtils::TrimCopy(measurandId);
+        const std::string_view trimmedId = StringUtils::TrimView(measurandId);
         const auto indexOpt = FindMeasurandIndexById(trimmedId);
         if (!indexOpt.has_value())
         {
@@ -196,13 +349,20 @@ public:
             throw std::invalid_argument("RemoveMeasurandById: Measurand is used by Samples.");
         }
 
+        std::optional<Measurand> oldValue;
+        if (notifier_.HasSubscribers())
+        {
+            oldValue.emplace(std::move(measurands_[indexOpt.value()]));
+        }
+
         measurands_.erase(measurands_.begin() + indexOpt.value());
+        NotifyRemoved(StudyEntity::Measurand, std::move(oldValue));
         return true;
     }
 
-    const Measurand &GetMeasurandById(const std::string &measurandId) const
+    const Measurand &GetMeasurandById(std::string_view measurandId) const
     {
-        const std::string trimmedId = StringUtils::TrimCopy(measurandId);
+        const std::string_view trimmedId = StringUtils::TrimView(measurandId);
         const auto indexOpt = FindMeasurandIndexById(trimmedId);
         if (!indexOpt.has_value())
         {
@@ -214,7 +374,22 @@ public:
 
     std::vector<Measurand> GetMeasurands() const
     {
-        return measurands_;
+        return std::vector<Measurand>(measurands_.begin(), measurands_.end());
+    }
+
+    std::size_t GetMeasurandCount() const noexcept
+    {
+        return measurands_.size();
+    }
+
+    // Visits every measurand in storage order without copying
+    template <typename Fn>
+    void ForEachMeasurand(Fn &&fn) const
+    {
+        for (const auto &measurand : measurands_)
+        {
+            fn(measurand);
+        }
     }
 
     // --------------------------------
@@ -222,7 +397,7 @@ public:
     // --------------------------------
     void AddSample(const Sample &sample)
     {
-        const std::string sampleId = StringUtils::TrimCopy(sample.GetSampleId());
+        const std::string_view sampleId = StringUtils::TrimView(sample.GetSampleId());
         if (sampleId.empty())
         {
             throw std::invalid_argument("AddSample: SampleId must not be empty.");
@@ -233,25 +408,49 @@ public:
             throw std::invalid_argument("AddSample: Duplicate SampleId.");
         }
 
-        const std::string measurandId = StringUtils::TrimCopy(sample.GetMeasurandId());
+        const std::string_view measurandId = StringUtils::TrimView(sample.GetMeasurandId());
         if (!FindMeasurandIndexById(measurandId).has_value())
         {
             throw std::invalid_argument("AddSample: MeasurandId not found.");
         }
 
         samples_.push_back(sample);
+        NotifyAdded(StudyEntity::Sample, samples_.back());
     }
 
-    bool UpdateSample(const std::string &sampleId, const Sample &newSample)
+    // Constructs the sample in place from Sample constructor arguments
+    template <typename... Args>
+    const Sample &EmplaceSample(Args &&...args)
     {
-        const std::string trimmedId = StringUtils::TrimCopy(sampleId);
+        samples_.emplace_back(std::forward<Args>(args)...);
+        const Sample &sample = samples_.back();
+
+        if (FindSampleIndexById(sample.GetSampleId()).value() != samples_.size() - 1)
+        {
+            samples_.pop_back();
+            throw std::invalid_argument("EmplaceSample: Duplicate SampleId.");
+        }
+
+        if (!FindMeasurandIndexById(sample.GetMeasurandId()).has_value())
+        {
+            samples_.pop_back();
+            throw std::invalid_argument("EmplaceSample: MeasurandId not found.");
+        }
+
+        NotifyAdded(StudyEntity::Sample, samples_.back());
+        return samples_.back();
+    }
+
+    bool UpdateSample(std::string_view sampleId, const Sample &newSample)
+    {
+        const std::string_view trimmedId = StringUtils::TrimView(sampleId);
         const auto indexOpt = FindSampleIndexById(trimmedId);
         if (!indexOpt.has_value())
         {
             return false;
         }
 
-        const std::string newId = StringUtils::TrimCopy(newSample.GetSampleId());
+        const std::string_view newId = StringUtils::TrimView(newSample.GetSampleId());
         if (newId.empty())
         {
             throw std::invalid_argument("UpdateSample: New SampleId must not be empty.");
@@ -262,7 +461,7 @@ public:
             throw std::invalid_argument("UpdateSample: New SampleId already exists.");
         }
 
-        const std::string measurandId = StringUtils::TrimCopy(newSample.GetMeasurandId());
+        const std::string_view measurandId = StringUtils::TrimView(newSample.GetMeasurandId());
         if (!FindMeasurandIndexById(measurandId).has_value())
         {
             throw std::invalid_argument("UpdateSample: MeasurandId not found.");
@@ -275,13 +474,20 @@ public:
                 "UpdateSample: Cannot change SampleId while results exist for it.");
         }
 
+        std::optional<Sample> oldValue;
+        if (notifier_.HasSubscribers())
+        {
+            oldValue.emplace(samples_[indexOpt.value()]);
+        }
+
         samples_[indexOpt.value()] = newSample;
+        NotifyUpdated(StudyEntity::Sample, std::move(oldValue), samples_[indexOpt.value()]);
         return true;
     }
 
-    bool RemoveSampleById(const std::string &sampleId)
+    bool RemoveSampleById(std::string_view sampleId)
     {
-        const std::string trimmedId = StringUtils::TrimCopy(sampleId);
+        const std::string_view trimmedId = StringUtils::TrimView(sampleId);
         const auto indexOpt = FindSampleIndexById(trimmedId);
         if (!indexOpt.has_value())
         {
@@ -293,13 +499,20 @@ public:
             throw std::invalid_argument("RemoveSampleById: Sample has results.");
         }
 
+        std::optional<Sample> oldValue;
+        if (notifier_.HasSubscribers())
+        {
+            oldValue.emplace(std::move(samples_[indexOpt.value()]));
+        }
+
         samples_.erase(samples_.begin() + indexOpt.value());
+        NotifyRemoved(StudyEntity::Sample, std::move(oldValue));
         return true;
     }
 
-    const Sample &GetSampleById(const std::string &sampleId) const
+    const Sample &GetSampleById(std::string_view sampleId) const
     {
-        const std::string trimmedId = StringUtils::TrimCopy(sampleId);
+        const std::string_view trimmedId = StringUtils::TrimView(sampleId);
         const auto indexOpt = FindSampleIndexById(trimmedId);
         if (!indexOpt.has_value())
         {
@@ -311,7 +524,22 @@ public:
 
     std::vector<Sample> GetSamples() const
     {
-        return samples_;
+        return std::vector<Sample>(samples_.begin(), samples_.end());
+    }
+
+    std::size_t GetSampleCount() const noexcept
+    {
+        return samples_.size();
+    }
+
+    // Visits every sample in storage order without copying
+    template <typename Fn>
+    void ForEachSample(Fn &&fn) const
+    {
+        for (const auto &sample : samples_)
+        {
+            fn(sample);
+        }
     }
 
     // --------------------------------
@@ -319,8 +547,8 @@ public:
     // --------------------------------
     void AddMeasurementResult(const MeasurementResult &result)
     {
-        const std::string laboratoryId = StringUtils::TrimCopy(result.GetLaboratoryId());
-        const std::string sampleId = StringUtils::TrimCopy(result.GetSampleId());
+        const std::string_view laboratoryId = StringUtils::TrimView(result.GetLaboratoryId());
+        const std::string_view sampleId = StringUtils::TrimView(result.GetSampleId());
         const int replicateIndex = result.GetReplicateIndex();
 
         EnsureLaboratoryExists(laboratoryId);
@@ -332,17 +560,121 @@ public:
                 "AddMeasurementResult: Duplicate (LaboratoryId, SampleId, ReplicateIndex).");
         }
 
+        ReserveTimeIndex(1);
         results_.push_back(result);
+        IndexAppendedResults(results_.size() - 1);
+        NotifyAdded(StudyEntity::MeasurementResult, results_.back());
+    }
+
+    // Constructs the result in place from MeasurementResult constructor arguments
+    template <typename... Args>
+    const MeasurementResult &EmplaceMeasurementResult(Args &&...args)
+    {
+        ReserveTimeIndex(1);
+        results_.emplace_back(std::forward<Args>(args)...);
+        const MeasurementResult &result = results_.back();
+
+        if (!FindLaboratoryIndexById(result.GetLaboratoryId()).has_value())
+        {
+            results_.pop_back();
+            throw std::invalid_argument("EmplaceMeasurementResult: LaboratoryId not found.");
+        }
+
+        if (!FindSampleIndexById(result.GetSampleId()).has_value())
+        {
+            results_.pop_back();
+            throw std::invalid_argument("EmplaceMeasurementResult: SampleId not found.");
+        }
+
+        if (FindResultIndexByKey(result.GetLaboratoryId(), result.GetSampleId(), result.GetReplicateIndex()).value() !=
+            results_.size() - 1)
+        {
+            results_.pop_back();
+            throw std::invalid_argument(
+                "EmplaceMeasurementResult: Duplicate (LaboratoryId, SampleId, ReplicateIndex).");
+        }
+
+        IndexAppendedResults(results_.size() - 1);
+        NotifyAdded(StudyEntity::MeasurementResult, results_.back());
+        return results_.back();
+    }
+
+    // Adds a batch of results all-or-nothing: every result is validated against
+    // the study and the rest of the batch before any of them is appended.
+    // Subscribers are notified once for the whole batch.
+    void AddMeasurementResults(const std::vector<MeasurementResult> &results)
+    {
+        AddMeasurementResults(std::vector<MeasurementResult>(results));
+    }
+
+    // As above, moving the results in; when it throws, `results` is left as it was
+    void AddMeasurementResults(std::vector<MeasurementResult> &&results)
+    {
+        std::unordered_set<std::string_view> laboratoryIds;
+        laboratoryIds.reserve(laboratories_.size());
+        for (const auto &laboratory : laboratories_)
+        {
+            laboratoryIds.insert(laboratory.GetLaboratoryId());
+        }
+
+        std::unordered_set<std::string_view> sampleIds;
+        sampleIds.reserve(samples_.size());
+        for (const auto &sample : samples_)
+        {
+            sampleIds.insert(sample.GetSampleId());
+        }
+
+        std::unordered_set<MeasurementResultKeyView, MeasurementResultKeyHash> keys;
+        keys.reserve(results_.size() + results.size());
+        for (const auto &existing : results_)
+        {
+            keys.insert({existing.GetLaboratoryId(), existing.GetSampleId(), existing.GetReplicateIndex()});
+        }
+
+        for (const auto &result : results)
+        {
+            if (laboratoryIds.find(result.GetLaboratoryId()) == laboratoryIds.end())
+            {
+                throw std::invalid_argument("AddMeasurementResults: LaboratoryId not found.");
+            }
+
+            if (sampleIds.find(result.GetSampleId()) == sampleIds.end())
+            {
+                throw std::invalid_argument("AddMeasurementResults: SampleId not found.");
+            }
+
+            if (!keys.insert({result.GetLaboratoryId(), result.GetSampleId(), result.GetReplicateIndex()}).second)
+            {
+                throw std::invalid_argument(
+                    "AddMeasurementResults: Duplicate (LaboratoryId, SampleId, ReplicateIndex).");
+            }
+        }
+
+        const std::size_t firstAdded = results_.size();
+        results_.reserve(results_.size() + results.size());
+        ReserveTimeIndex(results.size());
+        std::move(results.begin(), results.end(), std::back_inserter(results_));
+        results.clear();
+        IndexAppendedResults(firstAdded);
+
+        if (notifier_.HasSubscribers())
+        {
+            StudyChangeNotifier::BatchScope batch(notifier_);
+            for (std::size_t index = firstAdded; index < results_.size(); ++index)
+            {
+                NotifyAdded(StudyEntity::MeasurementResult, results_[index]);
+            }
+        }
     }
 
     bool UpdateMeasurementResult(
-        const std::string &laboratoryId,
-        const std::string &sampleId,
+        std::string_view laboratoryId,
+        std::string_view sampleId,
         int replicateIndex,
         const MeasurementResult &newResult)
     {
-        const std::string labId = StringUtils::TrimCopy(laboratoryId);
-        const std::string sampId = StringUtils::TrimCopy(sampleId);
+        const std::string_view labId = StringUtils::TrimView(laboratoryId);
+        const std::string_view sampId = StringUtils::TrimView(sampleId);
 
         const auto indexOpt = FindResultIndexByKey(labId, sampId, replicateIndex);
         if (!indexOpt.has_value())
@@ -352,24 +684,32 @@ public:
 
         // Key changes are forbidden in this operation to keep integrity simple.
         // You can remove + add if you truly need to change keys.
-        if (StringUtils::TrimCopy(newResult.GetLaboratoryId()) != labId ||
-            StringUtils::TrimCopy(newResult.GetSampleId()) != sampId ||
+        if (StringUtils::TrimView(newResult.GetLaboratoryId()) != labId ||
+            StringUtils::TrimView(newResult.GetSampleId()) != sampId ||
             newResult.GetReplicateIndex() != replicateIndex)
         {
             throw std::invalid_argument("UpdateMeasurementResult: Key fields cannot change.");
         }
 
+        std::optional<MeasurementResult> oldValue;
+        if (notifier_.HasSubscribers())
+        {
+            oldValue.emplace(results_[indexOpt.value()]);
+        }
+
         results_[indexOpt.value()] = newResult;
+        ReindexResult(indexOpt.value());
+        NotifyUpdated(StudyEntity::MeasurementResult, std::move(oldValue), results_[indexOpt.value()]);
         return true;
     }
 
     bool RemoveMeasurementResult(
-        const std::string &laboratoryId,
-        const std::string &sampleId,
+        std::string_view laboratoryId,
+        std::string_view sampleId,
         int replicateIndex)
     {
-        const std::string labId = StringUtils::TrimCopy(laboratoryId);
-        const std::string sampId = StringUtils::TrimCopy(sampleId);
+        const std::string_view labId = StringUtils::TrimView(laboratoryId);
+        const std::string_view sampId = StringUtils::TrimView(sampleId);
 
         const auto indexOpt = FindResultIndexByKey(labId, sampId, replicateIndex);
         if (!indexOpt.has_value())
@@ -377,17 +717,25 @@ public:
             return false;
         }
 
+        std::optional<MeasurementResult> oldValue;
+        if (notifier_.HasSubscribers())
+        {
+            oldValue.emplace(std::move(results_[indexOpt.value()]));
+        }
+
         results_.erase(results_.begin() + indexOpt.value());
+        UnindexResult(indexOpt.value());
+        NotifyRemoved(StudyEntity::MeasurementResult, std::move(oldValue));
         return true;
     }
 
     const MeasurementResult &GetMeasurementResult(
-        const std::string &laboratoryId,
-        const std::string &sampleId,
+        std::string_view laboratoryId,
+        std::string_view sampleId,
         int replicateIndex) const
     {
-        const std::string labId = StringUtils::TrimCopy(laboratoryId);
-        const std::string sampId = StringUtils::TrimCopy(sampleId);
+        const std::string_view labId = StringUtils::TrimView(laboratoryId);
+        const std::string_view sampId = StringUtils::TrimView(sampleId);
 
         const auto indexOpt = FindResultIndexByKey(labId, sampId, replicateIndex);
         if (!indexOpt.has_value())
@@ -400,19 +748,96 @@ public:
 
     std::vector<MeasurementResult> GetMeasurementResults() const
     {
-        return results_;
+        return std::vector<MeasurementResult>(results_.begin(), results_.end());
+    }
+
+    std::size_t GetMeasurementResultCount() const noexcept
+    {
+        return results_.size();
+    }
+
+    // Visits every result in storage order without copying
+    template <typename Fn>
+    void ForEachMeasurementResult(Fn &&fn) const
+    {
+        for (const auto &result : results_)
+        {
+            fn(result);
+        }
+    }
+
+    // -------------------------
+    // Time index
+    // -------------------------
+
+    // Time key of results whose timestamp is empty or in a form DateTimeUtils
+    // does not read (e.g. basic format or week dates); they sort last
+    static constexpr std::int64_t NoTimestamp = std::numeric_limits<std::int64_t>::max();
+
+    // Visits every result as fn(result, epochMillis) in ascending timestamp
+    // order; results with equal timestamps keep storage order.
+    template <typename Fn>
+    void ForEachMeasurementResultByTime(Fn &&fn) const
+    {
+        for (const auto &entry : timeIndex_)
+        {
+            fn(results_[entry.position], entry.epochMillis);
+        }
+    }
+
+    // Visits the results with fromEpochMillis <= timestamp < toEpochMillis as
+    // fn(result, epochMillis), in ascending timestamp order: O(log n + k).
+    template <typename Fn>
+    void ForEachMeasurementResultInTimeRange(std::int64_t fromEpochMillis, std::int64_t toEpochMillis, Fn &&fn) const
+    {
+        const auto first = std::lower_bound(
+            timeIndex_.begin(), timeIndex_.end(), fromEpochMillis,
+            [](const TimeIndexEntry &entry, std::int64_t time)
+            { return entry.epochMillis < time; });
+
+        for (auto it = first; it != timeIndex_.end() && it->epochMillis < toEpochMillis; ++it)
+        {
+            fn(results_[it->position], it->epochMillis);
+        }
+    }
+
+    // Same as above with ISO 8601 bounds
+    template <typename Fn>
+    void ForEachMeasurementResultInTimeRange(std::string_view fromIso8601, std::string_view toIso8601, Fn &&fn) const
+    {
+        const auto from = DateTimeUtils::ParseIso8601ToEpochMillis(fromIso8601);
+        const auto to = DateTimeUtils::ParseIso8601ToEpochMillis(toIso8601);
+        if (!from.has_value() || !to.has_value())
+        {
+            throw std::invalid_argument("ForEachMeasurementResultInTimeRange: Invalid ISO 8601 bound.");
+        }
+
+        ForEachMeasurementResultInTimeRange(from.value(), to.value(), std::forward<Fn>(fn));
     }
 
 private:
-    std::string studyId_;
-    std::string title_;
-    std::string startDateIso8601_;
-    std::string endDateIso8601_;
+    std::pmr::string studyId_;
+    std::pmr::string title_;
+    std::pmr::string startDateIso8601_;
+    std::pmr::string endDateIso8601_;
+
+    std::pmr::vector<Laboratory> laboratories_;
+    std::pmr::vector<Measurand> measurands_;
+    std::pmr::vector<Sample> samples_;
+    std::pmr::vector<MeasurementResult> results_;
+
+    // Every result's parsed timestamp and position in results_, sorted by
+    // (epochMillis, position). Kept in step with results_ by every mutation,
+    // so timestamps are parsed once per stored result.
+    struct TimeIndexEntry
+    {
+        std::int64_t epochMillis;
+        std::size_t position;
+    };
+
+    std::pmr::vector<TimeIndexEntry> timeIndex_;
 
-    std::vector<Laboratory> laboratories_;
-    std::vector<Measurand> measurands_;
-    std::vector<Sample> samples_;
-    std::vector<MeasurementResult> results_;
+    mutable StudyChangeNotifier notifier_;
 
     void Validate() const
     {
@@ -422,10 +847,176 @@ private:
         }
     }
 
+    // -------------------------
+    // Change records
+    // -------------------------
+    static void SetChangeKey(StudyChange &change, const Laboratory &laboratory)
+    {
+        change.id.assign(laboratory.GetLaboratoryId());
+    }
+
+    static void SetChangeKey(StudyChange &change, const Measurand &measurand)
+    {
+        change.id.assign(measurand.GetMeasurandId());
+    }
+
+    static void SetChangeKey(StudyChange &change, const Sample &sample)
+    {
+        change.id.assign(sample.GetSampleId());
+    }
+
+    static void SetChangeKey(StudyChange &change, const MeasurementResult &result)
+    {
+        change.resultKey.laboratoryId.assign(result.GetLaboratoryId());
+        change.resultKey.sampleId.assign(result.GetSampleId());
+        change.resultKey.replicateIndex = result.GetReplicateIndex();
+    }
+
+    template <typename Entity>
+    void NotifyAdded(StudyEntity entity, const Entity &added)
+    {
+        if (!notifier_.HasSubscribers())
+        {
+            return;
+        }
+
+        StudyChange change;
+        change.entity = entity;
+        change.kind = StudyChangeKind::Added;
+        SetChangeKey(change, added);
+        change.newValue = added;
+        notifier_.Record(std::move(change));
+    }
+
+    template <typename Entity>
+    void NotifyUpdated(StudyEntity entity, std::optional<Entity> oldValue, const Entity &newValue)
+    {
+        if (!oldValue.has_value())
+        {
+            return;
+        }
+
+        StudyChange change;
+        change.entity = entity;
+        change.kind = StudyChangeKind::Updated;
+        SetChangeKey(change, oldValue.value());
+
+        // An id change is the old entity going away and a new one appearing,
+        // so records coalesced in a batch stay keyed by the current id
+        StudyChange newKey;
+        SetChangeKey(newKey, newValue);
+        if (newKey.id != change.id || !(newKey.resultKey == change.resultKey))
+        {
+            StudyChangeNotifier::BatchScope batch(notifier_);
+            NotifyRemoved(entity, std::move(oldValue));
+            NotifyAdded(entity, newValue);
+            return;
+        }
+
+        change.oldValue = std::move(oldValue.value());
+        change.newValue = newValue;
+        notifier_.Record(std::move(change));
+    }
+
+    template <typename Entity>
+    void NotifyRemoved(StudyEntity entity, std::optional<Entity> oldValue)
+    {
+        if (!oldValue.has_value())
+        {
+            return;
+        }
+
+        StudyChange change;
+        change.entity = entity;
+        change.kind = StudyChangeKind::Removed;
+        SetChangeKey(change, oldValue.value());
+        change.oldValue = std::move(oldValue.value());
+        notifier_.Record(std::move(change));
+    }
+
+    void NotifyPropertyChanged(std::string_view property, std::string oldValue, std::string_view newValue)
+    {
+        if (!notifier_.HasSubscribers() || oldValue == newValue)
+        {
+            return;
+        }
+
+        StudyChange change;
+        change.entity = StudyEntity::Study;
+        change.kind = StudyChangeKind::Updated;
+        change.id.assign(property);
+        change.oldValue = std::move(oldValue);
+        change.newValue = std::string(newValue);
+        notifier_.Record(std::move(change));
+    }
+
     // -------------------------
     // Find helpers (indexes)
     // -------------------------
-    std::optional<std::size_t> FindLaboratoryIndexById(const std::string &laboratoryId) const
+    static std::int64_t ParseTimestamp(const MeasurementResult &result) noexcept
+    {
+        return DateTimeUtils::ParseIso8601ToEpochMillis(result.GetTimestampIso8601()).value_or(NoTimestamp);
+    }
+
+    static bool TimeIndexLess(const TimeIndexEntry &a, const TimeIndexEntry &b) noexcept
+    {
+        return a.epochMillis != b.epochMillis ? a.epochMillis < b.epochMillis : a.position < b.position;
+    }
+
+    // Called before a mutation that appends results, so that indexing them
+    // afterwards cannot throw; grows geometrically like results_ does
+    void ReserveTimeIndex(std::size_t additional)
+    {
+        const std::size_t required = timeIndex_.size() + additional;
+        if (required > timeIndex_.capacity())
+        {
+            timeIndex_.reserve(std::max(required, 2 * timeIndex_.capacity()));
+        }
+    }
+
+    // Indexes results_[firstAppended..]; capacity was reserved beforehand
+    void IndexAppendedResults(std::size_t firstAppended) noexcept
+    {
+        const std::size_t indexed = timeIndex_.size();
+        for (std::size_t position = firstAppended; position < results_.size(); ++position)
+        {
+            timeIndex_.push_back({ParseTimestamp(results_[position]), position});
+        }
+
+        std::sort(timeIndex_.begin() + indexed, timeIndex_.end(), TimeIndexLess);
+        std::inplace_merge(timeIndex_.begin(), timeIndex_.begin() + indexed, timeIndex_.end(), TimeIndexLess);
+    }
+
+    // Moves the entry of results_[position] to where its new timestamp belongs
+    void ReindexResult(std::size_t position) noexcept
+    {
+        timeIndex_.erase(FindTimeIndexEntry(position));
+        const TimeIndexEntry entry{ParseTimestamp(results_[position]), position};
+        timeIndex_.insert(std::upper_bound(timeIndex_.begin(), timeIndex_.end(), entry, TimeIndexLess), entry);
+    }
+
+    // Drops the entry of the result erased at `position` and shifts the
+    // positions behind it down to match results_
+    void UnindexResult(std::size_t position) noexcept
+    {
+        timeIndex_.erase(FindTimeIndexEntry(position));
+        for (auto &entry : timeIndex_)
+        {
+            if (entry.position > position)
+            {
+                --entry.position;
+            }
+        }
+    }
+
+    std::pmr::vector<TimeIndexEntry>::iterator FindTimeIndexEntry(std::size_t position) noexcept
+    {
+        return std::find_if(timeIndex_.begin(), timeIndex_.end(),
+                            [position](const TimeIndexEntry &entry)
+                            { return entry.position == position; });
+    }
+
+    std::optional<std::size_t> FindLaboratoryIndexById(std::string_view laboratoryId) const
     {
         for (std::size_t index = 0; index < laboratories_.size(); ++index)
         {
@@ -437,7 +1028,7 @@ private:
         return std::nullopt;
     }
 
-    std::optional<std::size_t> FindMeasurandIndexById(const std::string &measurandId) const
+    std::optional<std::size_t> FindMeasurandIndexById(std::string_view measurandId) const
     {
         for (std::size_t index = 0; index < measurands_.size(); ++index)
         {
@@ -449,7 +1040,7 @@ private:
         return std::nullopt;
     }
 
-    std::optional<std::size_t> FindSampleIndexById(const std::string &sampleId) const
+    std::optional<std::size_t> FindSampleIndexById(std::string_view sampleId) const
     {
         for (std::size_t index = 0; index < samples_.size(); ++index)
         {
@@ -462,8 +1053,8 @@ private:
     }
 
     std::optional<std::size_t> FindResultIndexByKey(
-        const std::string &laboratoryId,
-        const std::string &sampleId,
+        std::string_view laboratoryId,
+        std::string_view sampleId,
         int replicateIndex) const
     {
         for (std::size_t index = 0; index < results_.size(); ++index)
@@ -482,28 +1073,28 @@ private:
     // -------------------------
     // Integrity checks
     // -------------------------
-    bool HasResultsForLaboratory(const std::string &laboratoryId) const
+    bool HasResultsForLaboratory(std::string_view laboratoryId) const
     {
         return std::any_of(results_.begin(), results_.end(),
                            [&](const MeasurementResult &r)
                            { return r.GetLaboratoryId() == laboratoryId; });
     }
 
-    bool HasResultsForSample(const std::string &sampleId) const
+    bool HasResultsForSample(std::string_view sampleId) const
     {
         return std::any_of(results_.begin(), results_.end(),
                            [&](const MeasurementResult &r)
                            { return r.GetSampleId() == sampleId; });
     }
 
-    bool HasSamplesForMeasurand(const std::string &measurandId) const
+    bool HasSamplesForMeasurand(std::string_view measurandId) const
     {
         return std::any_of(samples_.begin(), samples_.end(),
                            [&](const Sample &s)
                            { return s.GetMeasurandId() == measurandId; });
     }
 
-    void EnsureLaboratoryExists(const std::string &laboratoryId) const
+    void EnsureLaboratoryExists(std::string_view laboratoryId) const
     {
         if (!FindLaboratoryIndexById(laboratoryId).has_value())
         {
@@ -511,7 +1102,7 @@ private:
         }
     }
 
-    void EnsureSampleExists(const std::string &sampleId) const
+    void EnsureSampleExists(std::string_view sampleId) const
     {
         if (!FindSampleIndexById(sampleId).has_value())
         {
@@ -519,3 +1110,33 @@ private:
         }
     }
 };
+
+// Groups the changes made during its lifetime into one notification,
+// published from the destructor (also when leaving by an exception)
+class StudyChangeBatch
+{
+public:
+    explicit StudyChangeBatch(Study &study) noexcept
+        : study_(study)
+    {
+        study_.BeginBatch();
+    }
+
+    ~StudyChangeBatch()
+    {
+        try
+        {
+            study_.EndBatch();
+        }
+        catch (...)
+        {
+            // Subscriber exceptions are contained by the notifier; only allocation failures get here
+        }
+    }
+
+    StudyChangeBatch(const StudyChangeBatch &) = delete;
+    StudyChangeBatch &operator=(const StudyChangeBatch &) = delete;
+
+private:
+    Study &study_;
+};
@@ -0,0 +1,320 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <tuple>
+#include <cstddef>
+#include <utility>
+#include <variant>
+#include <optional>
+#include <stdexcept>
+#include <functional>
+
+#include "Laboratory.h"
+#include "Measurand.h"
+#include "Sample.h"
+#include "MeasurementResult.h"
+#include "MeasurementResultKey.h"
+
+enum class StudyEntity
+{
+    Study,
+    Laboratory,
+    Measurand,
+    Sample,
+    MeasurementResult
+};
+
+enum class StudyChangeKind
+{
+    Added,
+    Updated,
+    Removed,
+
+    // The whole study was replaced by assignment (or moved from); carries no
+    // key or values, subscribers should reload everything
+    Reset
+};
+
+// Old or new state carried by a StudyChange: std::monostate when there is
+// none (the old value of an addition, the new value of a removal), a string
+// for Study properties, otherwise a copy of the entity.
+using StudyChangeValue = std::variant<std::monostate, std::string, Laboratory, Measurand, Sample, MeasurementResult>;
+
+struct StudyChange
+{
+    StudyEntity entity = StudyEntity::Study;
+    StudyChangeKind kind = StudyChangeKind::Updated;
+
+    // LaboratoryId, MeasurandId or SampleId; the property name ("Title",
+    // "StartDateIso8601", "EndDateIso8601") for StudyEntity::Study.
+    // Empty for results, which are identified by resultKey.
+    // An update that changes the id is reported as Removed (old id) plus
+    // Added (new id), so the key of an Updated record never changes.
+    std::string id;
+    MeasurementResultKey resultKey;
+
+    StudyChangeValue oldValue;
+    StudyChangeValue newValue;
+};
+
+// Subscriber list and pending batch of a Study.
+//
+// Outside a batch every change is published on its own. Inside a batch
+// (BeginBatch / EndBatch, nestable) changes to the same entity are merged
+// and everything is published once when the outermost batch ends:
+// Added+Updated -> Added, Updated+Updated -> Updated, Added+Removed -> nothing,
+// Updated+Removed -> Removed, Removed+Added -> Updated. A Reset drops
+// everything recorded before it in the batch.
+//
+// Subscribers belong to one Study object and are never copied or moved with
+// it: a copy or move starts without subscribers, and assignment keeps the
+// target's own. Because the notifier is the study's last member, its
+// assignment runs after every entity was replaced and reports that as one
+// Reset to the target's subscribers; a moved-from study reports Reset to
+// its own subscribers as well.
+//
+// Exceptions thrown by subscribers are caught and discarded, so a failing
+// observer can neither undo nor interrupt the mutation that triggered it,
+// nor keep the remaining observers from being notified.
+class StudyChangeNotifier
+{
+public:
+    using Subscriber = std::function<void(const std::vector<StudyChange> &)>;
+    using SubscriptionId = std::size_t;
+
+    // Opens a batch for its lifetime; the batch is published when the
+    // outermost scope ends, also when it ends by an exception
+    class BatchScope
+    {
+    public:
+        explicit BatchScope(StudyChangeNotifier &notifier) noexcept
+            : notifier_(notifier)
+        {
+            notifier_.BeginBatch();
+        }
+
+        ~BatchScope()
+        {
+            try
+            {
+                notifier_.EndBatch();
+            }
+            catch (...)
+            {
+                // Only allocation failures get here; the batch is closed regardless
+            }
+        }
+
+        BatchScope(const BatchScope &) = delete;
+        BatchScope &operator=(const BatchScope &) = delete;
+
+    private:
+        StudyChangeNotifier &notifier_;
+    };
+
+    StudyChangeNotifier() = default;
+
+    StudyChangeNotifier(const StudyChangeNotifier &) noexcept
+    {
+    }
+
+    StudyChangeNotifier(StudyChangeNotifier &&other) noexcept
+    {
+        try
+        {
+            other.RecordReset();
+        }
+        catch (...)
+        {
+            // Only allocation failures get here; moving must not fail
+        }
+    }
+
+    StudyChangeNotifier &operator=(const StudyChangeNotifier &other)
+    {
+        if (this != &other)
+        {
+            RecordReset();
+        }
+        return *this;
+    }
+
+    StudyChangeNotifier &operator=(StudyChangeNotifier &&other)
+    {
+        if (this != &other)
+        {
+            RecordReset();
+            other.RecordReset();
+        }
+        return *this;
+    }
+
+    SubscriptionId Subscribe(Subscriber subscriber)
+    {
+        if (!subscriber)
+        {
+            throw std::invalid_argument("Subscribe: Subscriber must not be empty.");
+        }
+
+        const SubscriptionId id = nextSubscriptionId_++;
+        subscribers_.emplace_back(id, std::move(subscriber));
+        return id;
+    }
+
+    bool Unsubscribe(SubscriptionId id)
+    {
+        for (auto it = subscribers_.begin(); it != subscribers_.end(); ++it)
+        {
+            if (it->first == id)
+            {
+                subscribers_.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Change records are only built while someone listens
+    bool HasSubscribers() const noexcept
+    {
+        return !subscribers_.empty();
+    }
+
+    void BeginBatch() noexcept
+    {
+        ++batchDepth_;
+    }
+
+    void EndBatch()
+    {
+        if (batchDepth_ == 0)
+        {
+            throw std::logic_error("EndBatch: No batch is open.");
+        }
+
+        if (--batchDepth_ == 0)
+        {
+            Flush();
+        }
+    }
+
+    void Record(StudyChange change)
+    {
+        if (batchDepth_ == 0)
+        {
+            std::vector<StudyChange> changes;
+            changes.push_back(std::move(change));
+            Publish(changes);
+            return;
+        }
+
+        if (change.kind == StudyChangeKind::Reset)
+        {
+            pending_.clear();
+            pendingIndexes_.clear();
+            pending_.emplace_back(std::move(change));
+            return;
+        }
+
+        auto key = std::make_tuple(change.entity, change.id, change.resultKey);
+        const auto it = pendingIndexes_.find(key);
+        if (it == pendingIndexes_.end())
+        {
+            pendingIndexes_.emplace(std::move(key), pending_.size());
+            pending_.emplace_back(std::move(change));
+            return;
+        }
+
+        std::optional<StudyChange> &merged = pending_[it->second];
+        if (!Merge(merged.value(), std::move(change)))
+        {
+            merged.reset();
+            pendingIndexes_.erase(it);
+        }
+    }
+
+private:
+    using PendingKey = std::tuple<StudyEntity, std::string, MeasurementResultKey>;
+
+    std::vector<std::pair<SubscriptionId, Subscriber>> subscribers_;
+    SubscriptionId nextSubscriptionId_ = 1;
+
+    std::size_t batchDepth_ = 0;
+    std::vector<std::optional<StudyChange>> pending_;
+    std::map<PendingKey, std::size_t> pendingIndexes_;
+
+    void RecordReset()
+    {
+        if (!HasSubscribers())
+        {
+            return;
+        }
+
+        StudyChange change;
+        change.entity = StudyEntity::Study;
+        change.kind = StudyChangeKind::Reset;
+        Record(std::move(change));
+    }
+
+    // Folds a later change into an earlier one; false when they cancel out
+    static bool Merge(StudyChange &earlier, StudyChange &&later)
+    {
+        if (earlier.kind == StudyChangeKind::Added && later.kind == StudyChangeKind::Removed)
+        {
+            return false;
+        }
+
+        if (earlier.kind == StudyChangeKind::Removed && later.kind == StudyChangeKind::Added)
+        {
+            earlier.kind = StudyChangeKind::Updated;
+        }
+        else if (later.kind == StudyChangeKind::Removed)
+        {
+            earlier.kind = StudyChangeKind::Removed;
+        }
+
+        earlier.newValue = std::move(later.newValue);
+        return true;
+    }
+
+    void Flush()
+    {
+        std::vector<StudyChange> changes;
+        changes.reserve(pending_.size());
+        for (auto &change : pending_)
+        {
+            if (change.has_value())
+            {
+                changes.push_back(std::move(change.value()));
+            }
+        }
+        pending_.clear();
+        pendingIndexes_.clear();
+
+        if (!changes.empty())
+        {
+            Publish(changes);
+        }
+    }
+
+    // Subscribers may subscribe, unsubscribe or change the study while being
+    // notified; they are called from a snapshot of the list.
+    void Publish(const std::vector<StudyChange> &changes) const
+    {
+        const auto subscribers = subscribers_;
+        for (const auto &subscriber : subscribers)
+        {
+            try
+            {
+                subscriber.second(changes);
+            }
+            catch (...)
+            {
+                // See the class comment: subscriber failures stay with the subscriber
+            }
+        }
+    }
+};
@@ -0,0 +1,352 @@
+#pragma once
+
+#include <wx/wx.h>
+#include <wx/dcbuffer.h>
+#include <wx/filedlg.h>
+#include <wx/imagpng.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Study.h"
+#include "DistributionCache.h"
+#include "DistributionPlotSvg.h"
+
+// Histogram and kernel density plot of one sample, with a bandwidth slider.
+//
+// Distributions come from a DistributionCache, so switching samples rebuilds
+// at most one binned KDE and moving the slider costs one FFT convolution
+// (well under a millisecond for the default 1024-point grid, which is sized
+// so that the widest slider bandwidth still fits) plus the repaint.
+class DistributionPanel : public wxPanel
+{
+public:
+    explicit DistributionPanel(wxWindow *parent)
+        : wxPanel(parent, wxID_ANY)
+    {
+        SetBackgroundStyle(wxBG_STYLE_PAINT);
+
+        sampleChoice_ = new wxChoice(this, wxID_ANY);
+        bandwidthSlider_ = new wxSlider(this, wxID_ANY, SliderSteps / 2, 0, SliderSteps);
+        auto *exportSvgButton = new wxButton(this, wxID_ANY, "Export SVG...");
+        auto *exportPngButton = new wxButton(this, wxID_ANY, "Export PNG...");
+
+        auto *controlSizer = new wxBoxSizer(wxHORIZONTAL);
+        controlSizer->Add(new wxStaticText(this, wxID_ANY, "Sample"), 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 4);
+        controlSizer->Add(sampleChoice_, 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 12);
+        controlSizer->Add(new wxStaticText(this, wxID_ANY, "Bandwidth"), 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 4);
+        controlSizer->Add(bandwidthSlider_, 1, wxALIGN_CENTER_VERTICAL | wxRIGHT, 12);
+        controlSizer->Add(exportSvgButton, 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 4);
+        controlSizer->Add(exportPngButton, 0, wxALIGN_CENTER_VERTICAL);
+
+        plotArea_ = new wxWindow(this, wxID_ANY);
+        plotArea_->SetBackgroundStyle(wxBG_STYLE_PAINT);
+
+        auto *rootSizer = new wxBoxSizer(wxVERTICAL);
+        rootSizer->Add(controlSizer, 0, wxEXPAND | wxALL, 4);
+        rootSizer->Add(plotArea_, 1, wxEXPAND);
+        SetSizer(rootSizer);
+
+        plotArea_->Bind(wxEVT_PAINT, &DistributionPanel::OnPaint, this);
+        plotArea_->Bind(wxEVT_SIZE, [this](wxSizeEvent &event)
+                        {
+                            plotArea_->Refresh(false);
+                            event.Skip();
+                        });
+        sampleChoice_->Bind(wxEVT_CHOICE, [this](wxCommandEvent &)
+                            { OnSampleChanged(); });
+        bandwidthSlider_->Bind(wxEVT_SLIDER, [this](wxCommandEvent &)
+                               { plotArea_->Refresh(false); });
+        exportSvgButton->Bind(wxEVT_BUTTON, [this](wxCommandEvent &)
+                              { OnExport(false); });
+        exportPngButton->Bind(wxEVT_BUTTON, [this](wxCommandEvent &)
+                              { OnExport(true); });
+
+        UpdateControls();
+    }
+
+    ~DistributionPanel() override
+    {
+        if (study_ != nullptr)
+        {
+            study_->Unsubscribe(subscriptionId_);
+        }
+    }
+
+    // The study must outlive the panel or be replaced with SetStudy(nullptr).
+    // Plots follow the study's change notifications from then on.
+    void SetStudy(const Study *study)
+    {
+        if (study_ != nullptr)
+        {
+            study_->Unsubscribe(subscriptionId_);
+        }
+
+        study_ = study;
+        cache_.reset();
+        if (study_ != nullptr)
+        {
+            cache_ = std::make_unique<DistributionCache>(*study_);
+            subscriptionId_ = study_->Subscribe([this](const std::vector<StudyChange> &changes)
+                                                { OnStudyChanged(changes); });
+        }
+
+        RebuildSampleChoice(wxEmptyString);
+        OnSampleChanged();
+    }
+
+    bool ExportSvg(const wxString &path)
+    {
+        SampleDistribution *distribution = GetSelectedDistribution();
+        if (distribution == nullptr)
+        {
+            return false;
+        }
+
+        DistributionPlotSvg::WriteFile(std::filesystem::path(path.ToStdWstring()), *distribution, GetBandwidth(*distribution),
+                                       distribution->sampleId);
+        return true;
+    }
+
+    bool ExportPng(const wxString &path, const wxSize &size = wxSize(1280, 800))
+    {
+        if (GetSelectedDistribution() == nullptr)
+        {
+            return false;
+        }
+
+        if (wxImage::FindHandler(wxBITMAP_TYPE_PNG) == nullptr)
+        {
+            wxImage::AddHandler(new wxPNGHandler);
+        }
+
+        wxBitmap bitmap(size);
+        {
+            wxMemoryDC dc(bitmap);
+            Render(dc, size);
+        }
+        return bitmap.ConvertToImage().SaveFile(path, wxBITMAP_TYPE_PNG);
+    }
+
+private:
+    // Slider positions map to a log scale over the bandwidths the sample's grid supports
+    static constexpr int SliderSteps = 200;
+
+    const Study *study_ = nullptr;
+    Study::SubscriptionId subscriptionId_ = 0;
+    std::unique_ptr<DistributionCache> cache_;
+
+    wxChoice *sampleChoice_ = nullptr;
+    wxSlider *bandwidthSlider_ = nullptr;
+    wxWindow *plotArea_ = nullptr;
+
+    SampleDistribution *GetSelectedDistribution()
+    {
+        const int selection = sampleChoice_->GetSelection();
+        if (!cache_ || selection == wxNOT_FOUND)
+        {
+            return nullptr;
+        }
+        return cache_->Get(std::string(sampleChoice_->GetString(selection).utf8_str()));
+    }
+
+    double GetBandwidth(const SampleDistribution &distribution) const
+    {
+        const double fraction = static_cast<double>(bandwidthSlider_->GetValue()) / SliderSteps;
+        return distribution.minBandwidth * std::pow(distribution.maxBandwidth / distribution.minBandwidth, fraction);
+    }
+
+    static int GetSliderPosition(const SampleDistribution &distribution, double bandwidth)
+    {
+        if (!(distribution.maxBandwidth > distribution.minBandwidth))
+        {
+            return 0;
+        }
+
+        const double fraction = std::log(bandwidth / distribution.minBandwidth) /
+                                std::log(distribution.maxBandwidth / distribution.minBandwidth);
+        return static_cast<int>(std::lround(std::clamp(fraction, 0.0, 1.0) * SliderSteps));
+    }
+
+    // Refills the sample list, keeping `selection` selected when it still exists
+    void RebuildSampleChoice(const wxString &selection)
+    {
+        sampleChoice_->Clear();
+        if (study_ != nullptr)
+        {
+            study_->ForEachSample([this](const Sample &sample)
+                                  {
+                                      const std::string_view sampleId = sample.GetSampleId();
+                                      sampleChoice_->Append(wxString::FromUTF8(sampleId.data(), sampleId.size()));
+                                  });
+        }
+
+        if (sampleChoice_->GetCount() > 0)
+        {
+            const int index = sampleChoice_->FindString(selection, true);
+            sampleChoice_->SetSelection(index == wxNOT_FOUND ? 0 : index);
+        }
+    }
+
+    // Drops only the distributions whose samples or results changed
+    void OnStudyChanged(const std::vector<StudyChange> &changes)
+    {
+        bool samplesChanged = false;
+        for (const auto &change : changes)
+        {
+            if (change.kind == StudyChangeKind::Reset)
+            {
+                cache_->Clear();
+                samplesChanged = true;
+            }
+            else if (change.entity == StudyEntity::MeasurementResult)
+            {
+                cache_->Invalidate(change.resultKey.sampleId);
+            }
+            else if (change.entity == StudyEntity::Sample)
+            {
+                // Renames arrive as Removed + Added
+                cache_->Invalidate(change.id);
+                samplesChanged = samplesChanged || change.kind != StudyChangeKind::Updated;
+            }
+        }
+
+        if (samplesChanged)
+        {
+            const wxString selection = sampleChoice_->GetStringSelection();
+            RebuildSampleChoice(selection);
+            if (sampleChoice_->GetStringSelection() != selection)
+            {
+                OnSampleChanged();
+                return;
+            }
+            UpdateControls();
+        }
+        plotArea_->Refresh(false);
+    }
+
+    void UpdateControls()
+    {
+        const bool hasSamples = sampleChoice_->GetCount() > 0;
+        sampleChoice_->Enable(hasSamples);
+        bandwidthSlider_->Enable(hasSamples);
+    }
+
+    void OnSampleChanged()
+    {
+        const SampleDistribution *distribution = GetSelectedDistribution();
+        bandwidthSlider_->SetValue(distribution != nullptr
+                                       ? GetSliderPosition(*distribution, distribution->defaultBandwidth)
+                                       : SliderSteps / 2);
+        UpdateControls();
+        Layout();
+        plotArea_->Refresh(false);
+    }
+
+    void OnExport(bool png)
+    {
+        if (GetSelectedDistribution() == nullptr)
+        {
+            return;
+        }
+
+        wxFileDialog dialog(this, png ? "Export PNG" : "Export SVG", wxEmptyString,
+                            sampleChoice_->GetStringSelection() + (png ? ".png" : ".svg"),
+                            png ? "PNG files (*.png)|*.png" : "SVG files (*.svg)|*.svg",
+                            wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+        if (dialog.ShowModal() != wxID_OK)
+        {
+            return;
+        }
+
+        try
+        {
+            const bool written = png ? ExportPng(dialog.GetPath()) : ExportSvg(dialog.GetPath());
+            if (!written)
+            {
+                wxLogError("Could not write '%s'.", dialog.GetPath());
+            }
+        }
+        catch (const std::exception &e)
+        {
+            wxLogError("%s", e.what());
+        }
+    }
+
+    void OnPaint(wxPaintEvent &)
+    {
+        wxAutoBufferedPaintDC dc(plotArea_);
+        Render(dc, plotArea_->GetClientSize());
+    }
+
+    void Render(wxDC &dc, const wxSize &size)
+    {
+        dc.SetBackground(*wxWHITE_BRUSH);
+        dc.Clear();
+
+        SampleDistribution *distribution = GetSelectedDistribution();
+        if (distribution == nullptr)
+        {
+            const wxString message = study_ == nullptr ? "No study loaded" : "No results for this sample";
+            const wxSize extent = dc.GetTextExtent(message);
+            dc.SetTextForeground(*wxLIGHT_GREY);
+            dc.DrawText(message, (size.x - extent.x) / 2, (size.y - extent.y) / 2);
+            return;
+        }
+
+        const std::vector<double> &density = distribution->GetDensity(GetBandwidth(*distribution));
+        const DistributionPlotBounds bounds = distribution->GetPlotBounds(density);
+
+        constexpr int margin = 40;
+        const double plotWidth = static_cast<double>(size.x - 2 * margin);
+        const double plotHeight = static_cast<double>(size.y - 2 * margin);
+        if (plotWidth <= 0.0 || plotHeight <= 0.0)
+        {
+            return;
+        }
+
+        const double xScale = plotWidth / (bounds.xMax - bounds.xMin);
+        const double yScale = plotHeight / bounds.yMax;
+        const auto toX = [&](double x) { return static_cast<int>(std::lround(margin + (x - bounds.xMin) * xScale)); };
+        const auto toY = [&](double y) { return static_cast<int>(std::lround(size.y - margin - y * yScale)); };
+
+        // Histogram bars
+        const Histogram &histogram = distribution->histogram;
+        dc.SetPen(wxPen(wxColour(0x4f, 0x81, 0xbd)));
+        dc.SetBrush(wxBrush(wxColour(0xc6, 0xd9, 0xf1)));
+        for (std::size_t bin = 0; bin < histogram.counts.size(); ++bin)
+        {
+            const double left = histogram.lower + histogram.binWidth * static_cast<double>(bin);
+            const int x0 = toX(left);
+            const int x1 = toX(left + histogram.binWidth);
+            const int top = toY(distribution->GetHistogramDensity(bin));
+            dc.DrawRectangle(x0, top, x1 - x0, size.y - margin - top);
+        }
+
+        // KDE curve
+        std::vector<wxPoint> points;
+        points.reserve(density.size());
+        for (std::size_t index = 0; index < density.size(); ++index)
+        {
+            points.emplace_back(toX(distribution->density.GetGridPoint(index)), toY(density[index]));
+        }
+        dc.SetPen(wxPen(wxColour(0xc0, 0x50, 0x4d), 2));
+        dc.DrawLines(static_cast<int>(points.size()), points.data());
+
+        // Axes and labels
+        dc.SetPen(*wxBLACK_PEN);
+        dc.DrawLine(margin, margin, margin, size.y - margin);
+        dc.DrawLine(margin, size.y - margin, size.x - margin, size.y - margin);
+
+        dc.SetTextForeground(*wxBLACK);
+        dc.DrawText(wxString::FromUTF8(distribution->sampleId.c_str()), margin, margin / 2 - 8);
+        dc.DrawText(wxString::FromDouble(bounds.xMin, 4), margin, size.y - margin + 4);
+        const wxString upperLabel = wxString::FromDouble(bounds.xMax, 4);
+        dc.DrawText(upperLabel, size.x - margin - dc.GetTextExtent(upperLabel).x, size.y - margin + 4);
+        dc.DrawText(wxString::Format("h = %g", distribution->cachedBandwidth), size.x - margin - 120, margin / 2 - 8);
+    }
+};
@@ -1,5 +1,11 @@
 #include <wx/wx.h>
 
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+
+#include "DistributionPanel.h"
+
 class MainFrame : public wxFrame
 {
 public:
@@ -11,10 +17,41 @@ public:
                   wxSize(900, 600))
     {
         BuildUi();
+        SetStudy(std::make_unique<Study>("Untitled"));
         Centre();
     }
 
+    // Child windows are destroyed by the wxWindow base, after study_ is gone;
+    // detach the panel while the study still exists
+    ~MainFrame() override
+    {
+        distributionPanel_->SetStudy(nullptr);
+    }
+
+    // Takes ownership of the study and shows its sample distributions
+    void SetStudy(std::unique_ptr<Study> study)
+    {
+        if (study == nullptr)
+        {
+            throw std::invalid_argument("SetStudy: Study must not be null.");
+        }
+
+        distributionPanel_->SetStudy(study.get());
+        study_ = std::move(study);
+
+        const std::string_view studyId = study_->GetStudyId();
+        SetStatusText(wxString::FromUTF8(studyId.data(), studyId.size()));
+    }
+
+    Study &GetStudy() noexcept
+    {
+        return *study_;
+    }
+
 private:
+    std::unique_ptr<Study> study_;
+    DistributionPanel *distributionPanel_ = nullptr;
+
     void BuildUi()
     {
         // Create a simple vertical layout
@@ -33,10 +70,12 @@ private:
             wxID_ANY,
             "Open-source software for Interlaboratory Studies");
 
-        rootSizer->AddStretchSpacer(1);
-        rootSizer->Add(title, 0, wxALIGN_CENTER | wxBOTTOM, 8);
-        rootSizer->Add(subtitle, 0, wxALIGN_CENTER);
-        rootSizer->AddStretchSpacer(1);
+        // Histogram / KDE plot of the selected sample
+        distributionPanel_ = new DistributionPanel(this);
+
+        rootSizer->Add(title, 0, wxALIGN_CENTER | wxTOP | wxBOTTOM, 8);
+        rootSizer->Add(subtitle, 0, wxALIGN_CENTER | wxBOTTOM, 8);
+        rootSizer->Add(distributionPanel_, 1, wxEXPAND | wxALL, 4);
 
         SetSizer(rootSizer);
 
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <charconv>
+#include <stdexcept>
+#include <filesystem>
+#include <new>
+
+// Sequential file writer with a large, reusable user-space buffer.
+//
+// Output is flushed with one fwrite per full buffer, so a report costs only a
+// handful of syscalls. One writer can be reopened for many files in turn,
+// which keeps the buffer allocation out of per-file work.
+class BufferedFileWriter
+{
+public:
+    static constexpr std::size_t DefaultBufferSize = 64 * 1024;
+
+    explicit BufferedFileWriter(std::size_t bufferSize = DefaultBufferSize)
+        : buffer_(bufferSize > 0 ? bufferSize : DefaultBufferSize)
+    {
+    }
+
+    BufferedFileWriter(const BufferedFileWriter &) = delete;
+    BufferedFileWriter &operator=(const BufferedFileWriter &) = delete;
+
+    ~BufferedFileWriter()
+    {
+        if (file_ != nullptr)
+        {
+            // Errors cannot be reported from a destructor; call Close() to see them
+            FlushBuffer(std::nothrow);
+            std::fclose(file_);
+        }
+    }
+
+    void Open(const std::filesystem::path &path)
+    {
+        Close();
+
+        file_ = std::fopen(path.string().c_str(), "wb");
+        if (file_ == nullptr)
+        {
+            throw std::runtime_error("BufferedFileWriter: Cannot open '" + path.string() + "' for writing.");
+        }
+
+        // The writer does its own buffering
+        std::setvbuf(file_, nullptr, _IONBF, 0);
+    }
+
+    void Close()
+    {
+        if (file_ == nullptr)
+        {
+            return;
+        }
+
+        const bool flushed = FlushBuffer(std::nothrow);
+        const bool closed = std::fclose(file_) == 0;
+        file_ = nullptr;
+
+        if (!flushed || !closed)
+        {
+            throw std::runtime_error("BufferedFileWriter: Write failed.");
+        }
+    }
+
+    void Write(std::string_view text)
+    {
+        if (text.size() > buffer_.size() - used_)
+        {
+            Flush();
+            if (text.size() > buffer_.size())
+            {
+                WriteToFile(text.data(), text.size());
+                return;
+            }
+        }
+
+        std::memcpy(buffer_.data() + used_, text.data(), text.size());
+        used_ += text.size();
+    }
+
+    void Write(char c)
+    {
+        if (used_ == buffer_.size())
+        {
+            Flush();
+        }
+        buffer_[used_++] = c;
+    }
+
+    // Shortest round-trip representation
+    void Write(double value)
+    {
+        char digits[32];
+        const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        Write(std::string_view(digits, static_cast<std::size_t>(result.ptr - digits)));
+    }
+
+    void Write(long long value)
+    {
+        char digits[24];
+        const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        Write(std::string_view(digits, static_cast<std::size_t>(result.ptr - digits)));
+    }
+
+    void Write(int value)
+    {
+        Write(static_cast<long long>(value));
+    }
+
+    void Write(std::size_t value)
+    {
+        Write(static_cast<long long>(value));
+    }
+
+    void Flush()
+    {
+        if (!FlushBuffer(std::nothrow))
+        {
+            throw std::runtime_error("BufferedFileWriter: Write failed.");
+        }
+    }
+
+private:
+    std::vector<char> buffer_;
+    std::size_t used_ = 0;
+    std::FILE *file_ = nullptr;
+
+    bool FlushBuffer(const std::nothrow_t &) noexcept
+    {
+        if (used_ == 0)
+        {
+            return true;
+        }
+
+        const bool ok = file_ != nullptr && std::fwrite(buffer_.data(), 1, used_, file_) == used_;
+        used_ = 0;
+        return ok;
+    }
+
+    void WriteToFile(const char *data, std::size_t size)
+    {
+        if (file_ == nullptr || std::fwrite(data, 1, size, file_) != size)
+        {
+            throw std::runtime_error("BufferedFileWriter: Write failed.");
+        }
+    }
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+#include <filesystem>
+
+#include "BufferedFileWriter.h"
+#include "ReportFormat.h"
+#include "DistributionCache.h"
+
+namespace DistributionPlotSvg
+{
+    // Histogram bars with the KDE curve on top, as a standalone SVG document
+    inline void Write(
+        BufferedFileWriter &writer,
+        SampleDistribution &distribution,
+        double bandwidth,
+        std::string_view title,
+        double width = 640.0,
+        double height = 400.0)
+    {
+        const std::vector<double> &density = distribution.GetDensity(bandwidth);
+        const DistributionPlotBounds bounds = distribution.GetPlotBounds(density);
+
+        constexpr double margin = 40.0;
+        const double plotWidth = width - 2.0 * margin;
+        const double plotHeight = height - 2.0 * margin;
+        const double xScale = plotWidth / (bounds.xMax - bounds.xMin);
+        const double yScale = plotHeight / bounds.yMax;
+        const auto toX = [&](double x) { return margin + (x - bounds.xMin) * xScale; };
+        const auto toY = [&](double y) { return height - margin - y * yScale; };
+
+        writer.Write("<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"");
+        writer.Write(width);
+        writer.Write("\" height=\"");
+        writer.Write(height);
+        writer.Write("\" font-family=\"sans-serif\" font-size=\"12\">\n<rect width=\"100%\" height=\"100%\" fill=\"#fff\"/>\n");
+
+        writer.Write("<text x=\"");
+        writer.Write(margin);
+        writer.Write("\" y=\"24\">");
+        ReportFormat::WriteHtmlEscaped(writer, title);
+        writer.Write("</text>\n");
+
+        const Histogram &histogram = distribution.histogram;
+        for (std::size_t bin = 0; bin < histogram.counts.size(); ++bin)
+        {
+            const double left = histogram.lower + histogram.binWidth * static_cast<double>(bin);
+            const double top = toY(distribution.GetHistogramDensity(bin));
+            writer.Write("<rect x=\"");
+            writer.Write(toX(left));
+            writer.Write("\" y=\"");
+            writer.Write(top);
+            writer.Write("\" width=\"");
+            writer.Write(histogram.binWidth * xScale);
+            writer.Write("\" height=\"");
+            writer.Write(height - margin - top);
+            writer.Write("\" fill=\"#c6d9f1\" stroke=\"#4f81bd\"/>\n");
+        }
+
+        writer.Write("<polyline fill=\"none\" stroke=\"#c0504d\" stroke-width=\"2\" points=\"");
+        for (std::size_t index = 0; index < density.size(); ++index)
+        {
+            writer.Write(toX(distribution.density.GetGridPoint(index)));
+            writer.Write(',');
+            writer.Write(toY(density[index]));
+            writer.Write(' ');
+        }
+        writer.Write("\"/>\n");
+
+        // Axes with the x range labelled at both ends
+        writer.Write("<path d=\"M");
+        writer.Write(margin);
+        writer.Write(' ');
+        writer.Write(margin);
+        writer.Write(" V");
+        writer.Write(height - margin);
+        writer.Write(" H");
+        writer.Write(width - margin);
+        writer.Write("\" fill=\"none\" stroke=\"#000\"/>\n<text x=\"");
+        writer.Write(margin);
+        writer.Write("\" y=\"");
+        writer.Write(height - margin + 16.0);
+        writer.Write("\">");
+        writer.Write(bounds.xMin);
+        writer.Write("</text>\n<text x=\"");
+        writer.Write(width - margin);
+        writer.Write("\" y=\"");
+        writer.Write(height - margin + 16.0);
+        writer.Write("\" text-anchor=\"end\">");
+        writer.Write(bounds.xMax);
+        writer.Write("</text>\n</svg>\n");
+    }
+
+    inline void WriteFile(
+        const std::filesystem::path &path,
+        SampleDistribution &distribution,
+        double bandwidth,
+        std::string_view title)
+    {
+        BufferedFileWriter writer;
+        writer.Open(path);
+        Write(writer, distribution, bandwidth, title);
+        writer.Close();
+    }
+}
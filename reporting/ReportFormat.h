@@ -0,0 +1,111 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <algorithm>
+
+#include "BufferedFileWriter.h"
+
+namespace ReportFormat
+{
+    // Writes text with HTML special characters escaped
+    inline void WriteHtmlEscaped(BufferedFileWriter &writer, std::string_view text)
+    {
+        std::size_t start = 0;
+        for (std::size_t index = 0; index < text.size(); ++index)
+        {
+            const char *entity = nullptr;
+            switch (text[index])
+            {
+            case '&': entity = "&amp;"; break;
+            case '<': entity = "&lt;"; break;
+            case '>': entity = "&gt;"; break;
+            case '"': entity = "&quot;"; break;
+            case '\'': entity = "&#39;"; break;
+            default: break;
+            }
+
+            if (entity != nullptr)
+            {
+                writer.Write(text.substr(start, index - start));
+                writer.Write(std::string_view(entity));
+                start = index + 1;
+            }
+        }
+        writer.Write(text.substr(start));
+    }
+
+    // Writes one CSV field (RFC 4180), quoting only when needed
+    inline void WriteCsvField(BufferedFileWriter &writer, std::string_view text)
+    {
+        if (text.find_first_of(",\"\r\n") == std::string_view::npos)
+        {
+            writer.Write(text);
+            return;
+        }
+
+        writer.Write('"');
+        std::size_t start = 0;
+        for (std::size_t quote = text.find('"'); quote != std::string_view::npos; quote = text.find('"', start))
+        {
+            writer.Write(text.substr(start, quote + 1 - start));
+            writer.Write('"');
+            start = quote + 1;
+        }
+        writer.Write(text.substr(start));
+        writer.Write('"');
+    }
+
+    // True for the names Windows reserves for devices (CON, PRN, AUX, NUL,
+    // COM1-COM9, LPT1-LPT9), compared case-insensitively; Windows also
+    // reserves them with any extension, so only the part before the first '.' counts
+    inline bool IsReservedDeviceName(std::string_view stem)
+    {
+        const std::string_view name = stem.substr(0, stem.find('.'));
+        const auto equals = [](std::string_view text, std::string_view upperCase)
+        {
+            return text.size() == upperCase.size() &&
+                   std::equal(text.begin(), text.end(), upperCase.begin(),
+                              [](char c, char reserved)
+                              { return (c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c) == reserved; });
+        };
+
+        if (equals(name, "CON") || equals(name, "PRN") || equals(name, "AUX") || equals(name, "NUL"))
+        {
+            return true;
+        }
+
+        const std::string_view device = name.substr(0, 3);
+        return name.size() == 4 && name[3] >= '1' && name[3] <= '9' &&
+               (equals(device, "COM") || equals(device, "LPT"));
+    }
+
+    // Maps an id to a portable file name stem: [A-Za-z0-9._-] kept, everything
+    // else '_'. Trailing dots are dropped (Windows strips them), and a stem that
+    // is empty, starts with '.' or is a reserved device name gets a '_' prefix.
+    inline std::string ToFileStem(std::string_view id)
+    {
+        std::string stem(id);
+        for (char &c : stem)
+        {
+            const bool safe = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') ||
+                              (c >= '0' && c <= '9') || c == '.' || c == '_' || c == '-';
+            if (!safe)
+            {
+                c = '_';
+            }
+        }
+
+        // Spaces are already '_', so dots are the only trailing characters left to strip
+        while (!stem.empty() && stem.back() == '.')
+        {
+            stem.pop_back();
+        }
+
+        if (stem.empty() || stem.front() == '.' || IsReservedDeviceName(stem))
+        {
+            stem.insert(stem.begin(), '_');
+        }
+        return stem;
+    }
+}
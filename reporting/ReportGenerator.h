@@ -0,0 +1,456 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include <optional>
+#include <cmath>
+#include <cctype>
+#include <filesystem>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "Study.h"
+#include "BufferedFileWriter.h"
+#include "ReportFormat.h"
+
+struct ReportOptions
+{
+    std::filesystem::path outputDirectory;
+
+    // 0 uses the hardware thread count
+    std::size_t threadCount = 0;
+
+    bool writeHtml = true;
+    bool writeCsv = true;
+};
+
+// Renders one report per participating laboratory plus a summary report.
+//
+// The generator indexes the study once and then renders participants in
+// parallel, each worker streaming its files through its own reusable
+// BufferedFileWriter; no report is ever held in memory as a whole.
+// The study must not be modified while a generator built from it is in use.
+class ReportGenerator
+{
+public:
+    explicit ReportGenerator(const Study &study)
+        : study_(study)
+    {
+        BuildIndex();
+    }
+
+    std::size_t GetParticipantCount() const noexcept
+    {
+        return participants_.size();
+    }
+
+    void Generate(const ReportOptions &options) const
+    {
+        std::filesystem::create_directories(options.outputDirectory);
+
+        std::size_t threadCount = options.threadCount;
+        if (threadCount == 0)
+        {
+            threadCount = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        }
+        threadCount = std::min(threadCount, std::max<std::size_t>(1, participants_.size()));
+
+        std::atomic<std::size_t> next{0};
+        std::atomic<bool> failed{false};
+        std::exception_ptr firstError;
+        std::mutex errorMutex;
+
+        auto worker = [&]()
+        {
+            try
+            {
+                BufferedFileWriter writer;
+                for (std::size_t index = next++; index < participants_.size() && !failed; index = next++)
+                {
+                    const Participant &participant = participants_[index];
+                    if (options.writeHtml)
+                    {
+                        writer.Open(options.outputDirectory / (participant.fileStem + ".html"));
+                        WriteParticipantHtml(writer, participant);
+                        writer.Close();
+                    }
+                    if (options.writeCsv)
+                    {
+                        writer.Open(options.outputDirectory / (participant.fileStem + ".csv"));
+                        WriteParticipantCsv(writer, participant);
+                        writer.Close();
+                    }
+                }
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!firstError)
+                {
+                    firstError = std::current_exception();
+                }
+                failed = true;
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount - 1);
+        for (std::size_t index = 1; index < threadCount; ++index)
+        {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        if (firstError)
+        {
+            std::rethrow_exception(firstError);
+        }
+
+        BufferedFileWriter writer;
+        if (options.writeHtml)
+        {
+            writer.Open(options.outputDirectory / "summary.html");
+            WriteSummaryHtml(writer, options.writeCsv);
+            writer.Close();
+        }
+        if (options.writeCsv)
+        {
+            writer.Open(options.outputDirectory / "summary.csv");
+            WriteSummaryCsv(writer);
+            writer.Close();
+        }
+    }
+
+private:
+    struct SampleInfo
+    {
+        const Sample *sample = nullptr;
+        const Measurand *measurand = nullptr;
+    };
+
+    struct Row
+    {
+        const MeasurementResult *result = nullptr;
+        SampleInfo sampleInfo;
+    };
+
+    struct Participant
+    {
+        const Laboratory *laboratory = nullptr;
+        std::string fileStem;
+        std::vector<Row> rows;
+    };
+
+    const Study &study_;
+    std::vector<Participant> participants_;
+
+    void BuildIndex()
+    {
+        std::unordered_map<std::string_view, SampleInfo> samples;
+        samples.reserve(study_.GetSampleCount());
+        study_.ForEachSample([&](const Sample &sample)
+                             { samples[sample.GetSampleId()] = {&sample, &study_.GetMeasurandById(sample.GetMeasurandId())}; });
+
+        std::unordered_map<std::string_view, std::size_t> participantIndexes;
+        std::unordered_set<std::string> usedStems;
+        participants_.reserve(study_.GetLaboratoryCount());
+        study_.ForEachLaboratory([&](const Laboratory &laboratory)
+                                 {
+                                     participantIndexes[laboratory.GetLaboratoryId()] = participants_.size();
+                                     participants_.push_back({&laboratory, UniqueStem(usedStems, laboratory.GetLaboratoryId()), {}});
+                                 });
+
+        study_.ForEachMeasurementResult([&](const MeasurementResult &result)
+                                        {
+                                            Participant &participant = participants_[participantIndexes.at(result.GetLaboratoryId())];
+                                            participant.rows.push_back({&result, samples.at(result.GetSampleId())});
+                                        });
+
+        for (auto &participant : participants_)
+        {
+            std::sort(participant.rows.begin(), participant.rows.end(),
+                      [](const Row &a, const Row &b)
+                      {
+                          if (a.result->GetSampleId() != b.result->GetSampleId())
+                          {
+                              return a.result->GetSampleId() < b.result->GetSampleId();
+                          }
+                          return a.result->GetReplicateIndex() < b.result->GetReplicateIndex();
+                      });
+        }
+    }
+
+    static std::string UniqueStem(std::unordered_set<std::string> &usedStems, std::string_view laboratoryId)
+    {
+        const std::string base = ReportFormat::ToFileStem(laboratoryId);
+        std::string stem = base;
+        for (int suffix = 2;; ++suffix)
+        {
+            // Compared case-insensitively, for case-insensitive file systems
+            std::string folded = stem;
+            std::transform(folded.begin(), folded.end(), folded.begin(),
+                           [](unsigned char c)
+                           { return static_cast<char>(std::tolower(c)); });
+
+            if (folded != "summary" && usedStems.insert(std::move(folded)).second)
+            {
+                return stem;
+            }
+            stem = base + "_" + std::to_string(suffix);
+        }
+    }
+
+    // Deviation from the assigned value, D = x - X
+    static std::optional<double> Deviation(const Row &row)
+    {
+        const auto &assignedValue = row.sampleInfo.sample->GetAssignedValue();
+        if (!assignedValue.has_value())
+        {
+            return std::nullopt;
+        }
+        return row.result->GetValue() - assignedValue.value();
+    }
+
+    // Percent deviation, D% = 100 (x - X) / X
+    static std::optional<double> PercentDeviation(const Row &row)
+    {
+        const auto &assignedValue = row.sampleInfo.sample->GetAssignedValue();
+        if (!assignedValue.has_value() || assignedValue.value() == 0.0)
+        {
+            return std::nullopt;
+        }
+        return 100.0 * (row.result->GetValue() - assignedValue.value()) / assignedValue.value();
+    }
+
+    static void WriteOptional(BufferedFileWriter &writer, const std::optional<double> &value)
+    {
+        if (value.has_value())
+        {
+            writer.Write(value.value());
+        }
+    }
+
+    void WriteHtmlHead(BufferedFileWriter &writer, std::string_view title) const
+    {
+        writer.Write("<!DOCTYPE html>\n<html><head><meta charset=\"utf-8\"><title>");
+        ReportFormat::WriteHtmlEscaped(writer, title);
+        writer.Write("</title>\n<style>body{font-family:sans-serif}table{border-collapse:collapse}"
+                     "td,th{border:1px solid #999;padding:2px 6px}td.n{text-align:right}</style>\n"
+                     "</head><body>\n<h1>");
+        ReportFormat::WriteHtmlEscaped(writer, study_.GetStudyId());
+        if (!study_.GetTitle().empty())
+        {
+            writer.Write(" &ndash; ");
+            ReportFormat::WriteHtmlEscaped(writer, study_.GetTitle());
+        }
+        writer.Write("</h1>\n");
+    }
+
+    void WriteParticipantHtml(BufferedFileWriter &writer, const Participant &participant) const
+    {
+        const Laboratory &laboratory = *participant.laboratory;
+        WriteHtmlHead(writer, laboratory.GetLaboratoryId());
+
+        writer.Write("<h2>Participant ");
+        ReportFormat::WriteHtmlEscaped(writer, laboratory.GetLaboratoryId());
+        writer.Write("</h2>\n<p>");
+        ReportFormat::WriteHtmlEscaped(writer, laboratory.GetLaboratoryName());
+        if (!laboratory.GetOrganization().empty())
+        {
+            writer.Write("<br>");
+            ReportFormat::WriteHtmlEscaped(writer, laboratory.GetOrganization());
+        }
+        if (!laboratory.GetLocation().empty())
+        {
+            writer.Write("<br>");
+            ReportFormat::WriteHtmlEscaped(writer, laboratory.GetLocation());
+        }
+        writer.Write("</p>\n<table>\n<tr><th>Sample</th><th>Measurand</th><th>Unit</th><th>Replicate</th>"
+                     "<th>Value</th><th>Assigned value</th><th>u(X)</th><th>D</th><th>D%</th></tr>\n");
+
+        for (const Row &row : participant.rows)
+        {
+            writer.Write("<tr><td>");
+            ReportFormat::WriteHtmlEscaped(writer, row.result->GetSampleId());
+            writer.Write("</td><td>");
+            ReportFormat::WriteHtmlEscaped(writer, row.sampleInfo.measurand->GetName());
+            writer.Write("</td><td>");
+            ReportFormat::WriteHtmlEscaped(writer, row.sampleInfo.measurand->GetUnit());
+            writer.Write("</td><td class=\"n\">");
+            writer.Write(row.result->GetReplicateIndex());
+            writer.Write("</td><td class=\"n\">");
+            writer.Write(row.result->GetValue());
+            writer.Write("</td><td class=\"n\">");
+            WriteOptional(writer, row.sampleInfo.sample->GetAssignedValue());
+            writer.Write("</td><td class=\"n\">");
+            WriteOptional(writer, row.sampleInfo.sample->GetStandardUncertainty());
+            writer.Write("</td><td class=\"n\">");
+            WriteOptional(writer, Deviation(row));
+            writer.Write("</td><td class=\"n\">");
+            WriteOptional(writer, PercentDeviation(row));
+            writer.Write("</td></tr>\n");
+        }
+
+        writer.Write("</table>\n");
+        WriteDeviationChart(writer, participant);
+        writer.Write("</body></html>\n");
+    }
+
+    // Inline SVG bar chart of D% per result, scaled to the largest |D%|
+    static void WriteDeviationChart(BufferedFileWriter &writer, const Participant &participant)
+    {
+        double maxAbs = 0.0;
+        std::size_t bars = 0;
+        for (const Row &row : participant.rows)
+        {
+            if (const auto percent = PercentDeviation(row))
+            {
+                maxAbs = std::max(maxAbs, std::abs(percent.value()));
+                ++bars;
+            }
+        }
+
+        if (bars == 0)
+        {
+            return;
+        }
+
+        constexpr double halfWidth = 200.0;
+        constexpr double barHeight = 14.0;
+        const double scale = maxAbs > 0.0 ? halfWidth / maxAbs : 0.0;
+
+        writer.Write("<h3>Deviation from assigned value (D%)</h3>\n<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"");
+        writer.Write(2.0 * halfWidth + 160.0);
+        writer.Write("\" height=\"");
+        writer.Write(static_cast<double>(bars) * barHeight + 4.0);
+        writer.Write("\">\n");
+
+        double y = 2.0;
+        for (const Row &row : participant.rows)
+        {
+            const auto percent = PercentDeviation(row);
+            if (!percent.has_value())
+            {
+                continue;
+            }
+
+            const double length = std::abs(percent.value()) * scale;
+            writer.Write("<text x=\"0\" y=\"");
+            writer.Write(y + barHeight - 3.0);
+            writer.Write("\" font-size=\"11\">");
+            ReportFormat::WriteHtmlEscaped(writer, row.result->GetSampleId());
+            writer.Write('/');
+            writer.Write(row.result->GetReplicateIndex());
+            writer.Write("</text><rect x=\"");
+            writer.Write(160.0 + halfWidth - (percent.value() < 0.0 ? length : 0.0));
+            writer.Write("\" y=\"");
+            writer.Write(y);
+            writer.Write("\" width=\"");
+            writer.Write(length);
+            writer.Write("\" height=\"");
+            writer.Write(barHeight - 2.0);
+            writer.Write(percent.value() < 0.0 ? "\" fill=\"#c0504d\"/>\n" : "\" fill=\"#4f81bd\"/>\n");
+            y += barHeight;
+        }
+
+        writer.Write("<line x1=\"");
+        writer.Write(160.0 + halfWidth);
+        writer.Write("\" y1=\"0\" x2=\"");
+        writer.Write(160.0 + halfWidth);
+        writer.Write("\" y2=\"");
+        writer.Write(y + 2.0);
+        writer.Write("\" stroke=\"#000\"/>\n</svg>\n");
+    }
+
+    void WriteParticipantCsv(BufferedFileWriter &writer, const Participant &participant) const
+    {
+        writer.Write("LaboratoryId,SampleId,MeasurandId,Unit,ReplicateIndex,Value,AssignedValue,StandardUncertainty,D,DPercent\r\n");
+        for (const Row &row : participant.rows)
+        {
+            ReportFormat::WriteCsvField(writer, row.result->GetLaboratoryId());
+            writer.Write(',');
+            ReportFormat::WriteCsvField(writer, row.result->GetSampleId());
+            writer.Write(',');
+            ReportFormat::WriteCsvField(writer, row.sampleInfo.measurand->GetMeasurandId());
+            writer.Write(',');
+            ReportFormat::WriteCsvField(writer, row.sampleInfo.measurand->GetUnit());
+            writer.Write(',');
+            writer.Write(row.result->GetReplicateIndex());
+            writer.Write(',');
+            writer.Write(row.result->GetValue());
+            writer.Write(',');
+            WriteOptional(writer, row.sampleInfo.sample->GetAssignedValue());
+            writer.Write(',');
+            WriteOptional(writer, row.sampleInfo.sample->GetStandardUncertainty());
+            writer.Write(',');
+            WriteOptional(writer, Deviation(row));
+            writer.Write(',');
+            WriteOptional(writer, PercentDeviation(row));
+            writer.Write("\r\n");
+        }
+    }
+
+    void WriteSummaryHtml(BufferedFileWriter &writer, bool linkCsv) const
+    {
+        WriteHtmlHead(writer, "Summary");
+        writer.Write("<h2>Summary</h2>\n<p>");
+        writer.Write(participants_.size());
+        writer.Write(" participants, ");
+        writer.Write(study_.GetMeasurementResultCount());
+        writer.Write(" results.</p>\n<table>\n<tr><th>Laboratory</th><th>Name</th><th>Results</th><th>Report</th></tr>\n");
+
+        for (const auto &participant : participants_)
+        {
+            writer.Write("<tr><td>");
+            ReportFormat::WriteHtmlEscaped(writer, participant.laboratory->GetLaboratoryId());
+            writer.Write("</td><td>");
+            ReportFormat::WriteHtmlEscaped(writer, participant.laboratory->GetLaboratoryName());
+            writer.Write("</td><td class=\"n\">");
+            writer.Write(participant.rows.size());
+            writer.Write("</td><td><a href=\"");
+            ReportFormat::WriteHtmlEscaped(writer, participant.fileStem);
+            writer.Write(".html\">HTML</a>");
+            if (linkCsv)
+            {
+                writer.Write(" <a href=\"");
+                ReportFormat::WriteHtmlEscaped(writer, participant.fileStem);
+                writer.Write(".csv\">CSV</a>");
+            }
+            writer.Write("</td></tr>\n");
+        }
+
+        writer.Write("</table>\n</body></html>\n");
+    }
+
+    void WriteSummaryCsv(BufferedFileWriter &writer) const
+    {
+        writer.Write("LaboratoryId,LaboratoryName,Organization,Location,ResultCount,ReportFile\r\n");
+        for (const auto &participant : participants_)
+        {
+            const Laboratory &laboratory = *participant.laboratory;
+            ReportFormat::WriteCsvField(writer, laboratory.GetLaboratoryId());
+            writer.Write(',');
+            ReportFormat::WriteCsvField(writer, laboratory.GetLaboratoryName());
+            writer.Write(',');
+            ReportFormat::WriteCsvField(writer, laboratory.GetOrganization());
+            writer.Write(',');
+            ReportFormat::WriteCsvField(writer, laboratory.GetLocation());
+            writer.Write(',');
+            writer.Write(participant.rows.size());
+            writer.Write(',');
+            ReportFormat::WriteCsvField(writer, participant.fileStem);
+            writer.Write("\r\n");
+        }
+    }
+};
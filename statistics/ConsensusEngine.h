@@ -0,0 +1,135 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <optional>
+#include <unordered_map>
+
+#include "Study.h"
+#include "ConsensusEstimator.h"
+#include "Reduction.h"
+
+// Computes an uncertainty-weighted consensus value per Sample and writes it
+// into the sample's assigned value and standard uncertainty.
+//
+// Each laboratory contributes one point per sample: the mean of its
+// replicates, with the mean of the standard uncertainties it reported for
+// them. Laboratories that did not report an uncertainty for every replicate,
+// or reported only zeros, are left out. Samples with fewer than two
+// contributing laboratories are not changed, and neither are samples whose
+// Paule-Mandel solve did not converge; those are still returned, with
+// ConsensusResult::converged == false, so the caller can report them.
+class ConsensusEngine
+{
+public:
+    explicit ConsensusEngine(ConsensusMethod method, ConsensusEstimator::Options options = {})
+        : method_(method),
+          estimator_(options)
+    {
+    }
+
+    // Returns the consensus of every sample with at least two contributing
+    // laboratories, keyed by SampleId
+    std::map<std::string, ConsensusResult> Evaluate(Study &study)
+    {
+        const std::vector<SampleData> samples = Collect(study);
+
+        // Observers of the study see all updated samples in one notification
+        StudyChangeBatch batch(study);
+
+        std::map<std::string, ConsensusResult> results;
+        for (const auto &sampleData : samples)
+        {
+            estimator_.Clear();
+            for (const auto &laboratory : sampleData.laboratories)
+            {
+                const double uncertaintySum = laboratory.uncertaintySum.GetSum();
+                if (laboratory.uncertaintyCount == laboratory.valueCount && uncertaintySum > 0.0)
+                {
+                    estimator_.Add(laboratory.valueSum.GetSum() / laboratory.valueCount,
+                                   uncertaintySum / laboratory.uncertaintyCount);
+                }
+            }
+
+            const auto consensus = estimator_.Estimate(method_);
+            if (!consensus.has_value())
+            {
+                continue;
+            }
+
+            results.emplace(sampleData.sampleId, consensus.value());
+            if (!consensus->converged)
+            {
+                continue;
+            }
+
+            Sample updated = study.GetSampleById(sampleData.sampleId);
+            updated.SetAssignedValue(consensus->value);
+            updated.SetStandardUncertainty(consensus->standardUncertainty);
+            study.UpdateSample(sampleData.sampleId, updated);
+        }
+        return results;
+    }
+
+private:
+    struct LaboratoryData
+    {
+        Reduction::CompensatedSum valueSum;
+        Reduction::CompensatedSum uncertaintySum;
+        int valueCount = 0;
+        int uncertaintyCount = 0;
+    };
+
+    struct SampleData
+    {
+        std::string sampleId;
+        std::string measurandId;
+        std::vector<LaboratoryData> laboratories;
+    };
+
+    ConsensusMethod method_;
+    ConsensusEstimator estimator_;
+
+    // One pass over the results, grouped by sample then laboratory.
+    // Samples are ordered by measurand so the warm start carries over
+    // between samples of similar scale.
+    static std::vector<SampleData> Collect(const Study &study)
+    {
+        std::vector<SampleData> samples;
+        std::unordered_map<std::string_view, std::size_t> sampleIndexes;
+        samples.reserve(study.GetSampleCount());
+        study.ForEachSample([&](const Sample &sample)
+                            {
+                                sampleIndexes.emplace(sample.GetSampleId(), samples.size());
+                                samples.push_back({std::string(sample.GetSampleId()), std::string(sample.GetMeasurandId()), {}});
+                            });
+
+        std::vector<std::unordered_map<std::string_view, std::size_t>> laboratoryIndexes(samples.size());
+        study.ForEachMeasurementResult([&](const MeasurementResult &result)
+                                       {
+                                           const std::size_t sampleIndex = sampleIndexes.at(result.GetSampleId());
+                                           auto &laboratories = samples[sampleIndex].laboratories;
+                                           const auto [it, inserted] = laboratoryIndexes[sampleIndex].emplace(result.GetLaboratoryId(), laboratories.size());
+                                           if (inserted)
+                                           {
+                                               laboratories.emplace_back();
+                                           }
+
+                                           LaboratoryData &laboratory = laboratories[it->second];
+                                           laboratory.valueSum.Add(result.GetValue());
+                                           ++laboratory.valueCount;
+                                           if (result.GetStandardUncertainty().has_value())
+                                           {
+                                               laboratory.uncertaintySum.Add(result.GetStandardUncertainty().value());
+                                               ++laboratory.uncertaintyCount;
+                                           }
+                                       });
+
+        std::stable_sort(samples.begin(), samples.end(),
+                         [](const SampleData &a, const SampleData &b)
+                         { return a.measurandId < b.measurandId; });
+        return samples;
+    }
+};
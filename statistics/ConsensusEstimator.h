@@ -0,0 +1,257 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <algorithm>
+
+#include "Reduction.h"
+
+enum class ConsensusMethod
+{
+    DerSimonianLaird,
+    PauleMandel
+};
+
+struct ConsensusResult
+{
+    double value = std::numeric_limits<double>::quiet_NaN();
+    double standardUncertainty = std::numeric_limits<double>::quiet_NaN();
+
+    // Between-laboratory variance
+    double tau2 = 0.0;
+
+    std::size_t laboratoryCount = 0;
+
+    // Root-finding iterations (Paule-Mandel only)
+    int iterations = 0;
+
+    // False when Paule-Mandel stopped (out of iterations, or no further
+    // progress in double precision) without |F(tau2)| meeting the tolerance;
+    // value and uncertainty are then the last iterate
+    bool converged = true;
+};
+
+// Uncertainty-weighted consensus of one value and standard uncertainty per
+// laboratory, using a random-effects model x_i ~ N(mu, u_i^2 + tau^2).
+//
+// Inputs are kept as two flat arrays (values, u_i^2) and every weighted sum
+// goes through Reduction::SumOf, so results are reproducible bit for bit.
+// Reused across samples, the estimator keeps its buffers and warm-starts
+// Paule-Mandel from the previous solution.
+class ConsensusEstimator
+{
+public:
+    struct Options
+    {
+        int maxIterations = 100;
+
+        // Stop when |F(tau2)| <= tolerance * (k - 1)
+        double tolerance = 1e-10;
+    };
+
+    ConsensusEstimator() = default;
+
+    explicit ConsensusEstimator(Options options)
+        : options_(options)
+    {
+    }
+
+    void Clear() noexcept
+    {
+        values_.clear();
+        variances_.clear();
+    }
+
+    // Adds one laboratory; standardUncertainty must be > 0
+    void Add(double value, double standardUncertainty)
+    {
+        if (!std::isfinite(value) || !std::isfinite(standardUncertainty) || standardUncertainty <= 0.0)
+        {
+            throw std::invalid_argument("ConsensusEstimator::Add: Value must be finite and uncertainty > 0.");
+        }
+
+        values_.push_back(value);
+        variances_.push_back(standardUncertainty * standardUncertainty);
+    }
+
+    std::size_t GetCount() const noexcept { return values_.size(); }
+
+    // Needs at least two laboratories
+    std::optional<ConsensusResult> Estimate(ConsensusMethod method)
+    {
+        if (values_.size() < 2)
+        {
+            return std::nullopt;
+        }
+
+        const double tau2DerSimonianLaird = DerSimonianLairdTau2();
+
+        ConsensusResult result;
+        result.laboratoryCount = values_.size();
+        if (method == ConsensusMethod::DerSimonianLaird)
+        {
+            result.tau2 = tau2DerSimonianLaird;
+        }
+        else
+        {
+            result.tau2 = PauleMandelTau2(tau2DerSimonianLaird, result.iterations, result.converged);
+            if (result.converged)
+            {
+                lastPauleMandelScale_ = result.tau2 > 0.0 ? result.tau2 / MeanVariance() : 0.0;
+            }
+        }
+
+        const WeightedSums sums = ComputeWeightedSums(result.tau2);
+        result.value = sums.weightedValue / sums.weight;
+        result.standardUncertainty = 1.0 / std::sqrt(sums.weight);
+        return result;
+    }
+
+private:
+    struct WeightedSums
+    {
+        double weight = 0.0;
+        double weightedValue = 0.0;
+    };
+
+    Options options_;
+    std::vector<double> values_;
+    std::vector<double> variances_;
+
+    // tau2 of the previous Paule-Mandel solve relative to the mean u_i^2,
+    // used as the starting point for the next sample
+    double lastPauleMandelScale_ = -1.0;
+
+    WeightedSums ComputeWeightedSums(double tau2) const
+    {
+        const double *values = values_.data();
+        const double *variances = variances_.data();
+
+        WeightedSums sums;
+        sums.weight = Reduction::SumOf(values_.size(), [variances, tau2](std::size_t index)
+                                       { return 1.0 / (variances[index] + tau2); });
+        sums.weightedValue = Reduction::SumOf(values_.size(), [values, variances, tau2](std::size_t index)
+                                              { return values[index] / (variances[index] + tau2); });
+        return sums;
+    }
+
+    double MeanVariance() const
+    {
+        return Reduction::Mean(variances_);
+    }
+
+    // Moment estimator: tau2 = max(0, (Q - (k - 1)) / (S1 - S2 / S1))
+    double DerSimonianLairdTau2() const
+    {
+        const std::size_t count = values_.size();
+        const WeightedSums sums = ComputeWeightedSums(0.0);
+        const double mean = sums.weightedValue / sums.weight;
+
+        const double *values = values_.data();
+        const double *variances = variances_.data();
+        const double q = Reduction::SumOf(count, [values, variances, mean](std::size_t index)
+                                          { return (values[index] - mean) * (values[index] - mean) / variances[index]; });
+        const double sumSquaredWeights = Reduction::SumOf(count, [variances](std::size_t index)
+                                                          { return 1.0 / (variances[index] * variances[index]); });
+
+        const double denominator = sums.weight - sumSquaredWeights / sums.weight;
+        if (denominator <= 0.0)
+        {
+            return 0.0;
+        }
+        return std::max(0.0, (q - static_cast<double>(count - 1)) / denominator);
+    }
+
+    // Generalised Q statistic minus its expectation, F(tau2) = sum w_i (x_i - mu)^2 - (k - 1),
+    // and its derivative dF/dtau2 = -sum w_i^2 (x_i - mu)^2. F is decreasing in tau2.
+    void EvaluatePauleMandel(double tau2, double &f, double &derivative) const
+    {
+        const std::size_t count = values_.size();
+        const WeightedSums sums = ComputeWeightedSums(tau2);
+        const double mean = sums.weightedValue / sums.weight;
+
+        const double *values = values_.data();
+        const double *variances = variances_.data();
+        const double q = Reduction::SumOf(count, [values, variances, mean, tau2](std::size_t index)
+                                          { return (values[index] - mean) * (values[index] - mean) / (variances[index] + tau2); });
+        const double slope = Reduction::SumOf(count, [values, variances, mean, tau2](std::size_t index)
+                                              {
+                                                  const double weight = 1.0 / (variances[index] + tau2);
+                                                  return weight * weight * (values[index] - mean) * (values[index] - mean);
+                                              });
+
+        f = q - static_cast<double>(count - 1);
+        derivative = -slope;
+    }
+
+    // Safeguarded Newton iteration on F(tau2) = 0 inside a shrinking bracket
+    double PauleMandelTau2(double tau2DerSimonianLaird, int &iterations, bool &converged) const
+    {
+        converged = true;
+        const double tolerance = options_.tolerance * static_cast<double>(values_.size() - 1);
+
+        double f = 0.0;
+        double derivative = 0.0;
+        EvaluatePauleMandel(0.0, f, derivative);
+        iterations = 1;
+        if (f <= tolerance)
+        {
+            return 0.0;
+        }
+
+        // Start from the previous sample's solution, scaled to this sample's
+        // uncertainties, when available; otherwise from the DL estimate.
+        double tau2 = lastPauleMandelScale_ > 0.0 ? lastPauleMandelScale_ * MeanVariance() : tau2DerSimonianLaird;
+        if (!(tau2 > 0.0))
+        {
+            tau2 = MeanVariance();
+        }
+
+        double low = 0.0;
+        double high = std::numeric_limits<double>::infinity();
+        while (iterations < options_.maxIterations)
+        {
+            EvaluatePauleMandel(tau2, f, derivative);
+            ++iterations;
+
+            if (std::abs(f) <= tolerance)
+            {
+                return tau2;
+            }
+
+            if (f > 0.0)
+            {
+                low = tau2;
+            }
+            else
+            {
+                high = tau2;
+            }
+
+            double next = derivative < 0.0 ? tau2 - f / derivative : std::numeric_limits<double>::quiet_NaN();
+            if (!(next > low && next < high))
+            {
+                // Newton left the bracket: bisect, or expand while no upper bound is known
+                next = std::isinf(high) ? 2.0 * std::max(tau2, low) : 0.5 * (low + high);
+            }
+
+            // No further progress in double precision; the step is measured
+            // against the scale of the data, not an absolute floor
+            if (std::abs(next - tau2) <= 1e-15 * std::max(tau2, MeanVariance()))
+            {
+                tau2 = next;
+                break;
+            }
+            tau2 = next;
+        }
+
+        // Stalled or out of iterations: only a root within tolerance counts
+        EvaluatePauleMandel(tau2, f, derivative);
+        ++iterations;
+        converged = std::abs(f) <= tolerance;
+        return tau2;
+    }
+};
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "Study.h"
+#include "KernelDensity.h"
+#include "Reduction.h"
+
+// Data-space extent shared by the SVG and on-screen plots
+struct DistributionPlotBounds
+{
+    double xMin = 0.0;
+    double xMax = 1.0;
+    double yMax = 1.0;
+};
+
+// Plot data of one sample: one value per participant (the mean of its
+// replicates), their histogram and a binned KDE ready for re-evaluation
+struct SampleDistribution
+{
+    std::string sampleId;
+    std::vector<double> values;
+    Histogram histogram;
+    BinnedKernelDensity density;
+    double defaultBandwidth = 0.0;
+
+    // Bandwidths the grid resolves: the lower bound spans at least two grid
+    // steps, and the grid reaches far enough past the data that the kernel
+    // tails of the upper bound stay on it
+    double minBandwidth = 0.0;
+    double maxBandwidth = 0.0;
+
+    // Density for the last requested bandwidth
+    double cachedBandwidth = 0.0;
+    std::vector<double> cachedDensity;
+
+    // Bandwidths outside [minBandwidth, maxBandwidth] are clamped
+    const std::vector<double> &GetDensity(double bandwidth)
+    {
+        bandwidth = std::clamp(bandwidth, minBandwidth, maxBandwidth);
+        if (cachedDensity.empty() || bandwidth != cachedBandwidth)
+        {
+            cachedDensity = density.Evaluate(bandwidth);
+            cachedBandwidth = bandwidth;
+        }
+        return cachedDensity;
+    }
+
+    // Histogram bars are scaled to densities (count / (n * binWidth)) so they share the KDE's y axis
+    double GetHistogramDensity(std::size_t bin) const
+    {
+        return static_cast<double>(histogram.counts.at(bin)) /
+               (static_cast<double>(values.size()) * histogram.binWidth);
+    }
+
+    DistributionPlotBounds GetPlotBounds(const std::vector<double> &densityValues) const
+    {
+        DistributionPlotBounds bounds;
+        bounds.xMin = std::min(histogram.lower, density.GetLower());
+        bounds.xMax = std::max(histogram.GetUpper(), density.GetGridPoint(density.GetGridSize() - 1));
+
+        double yMax = 0.0;
+        for (std::size_t bin = 0; bin < histogram.counts.size(); ++bin)
+        {
+            yMax = std::max(yMax, GetHistogramDensity(bin));
+        }
+        for (const double value : densityValues)
+        {
+            yMax = std::max(yMax, value);
+        }
+        bounds.yMax = yMax > 0.0 ? yMax * 1.05 : 1.0;
+        return bounds;
+    }
+};
+
+// Lazily computed SampleDistribution per sample of a study.
+// Call Invalidate / Clear when the study's samples or results change,
+// e.g. from a Study::Subscribe callback.
+class DistributionCache
+{
+public:
+    // Supported bandwidths relative to the Silverman bandwidth
+    static constexpr double MinBandwidthFactor = 0.25;
+    static constexpr double MaxBandwidthFactor = 4.0;
+
+    // Grid margin beyond the data, in multiples of the largest bandwidth;
+    // a Gaussian keeps less than 1e-4 of its mass past 4 bandwidths
+    static constexpr double GridPadding = 4.0;
+
+    explicit DistributionCache(const Study &study, std::size_t gridSize = 1024)
+        : study_(study),
+          gridSize_(gridSize)
+    {
+    }
+
+    // nullptr when the sample has no results
+    SampleDistribution *Get(std::string_view sampleId)
+    {
+        const std::string key = StringUtils::TrimCopy(sampleId);
+        const auto it = entries_.find(key);
+        if (it != entries_.end())
+        {
+            return it->second.get();
+        }
+
+        std::unique_ptr<SampleDistribution> distribution = Build(key);
+        SampleDistribution *result = distribution.get();
+        entries_.emplace(key, std::move(distribution));
+        return result;
+    }
+
+    void Invalidate(std::string_view sampleId)
+    {
+        entries_.erase(StringUtils::TrimCopy(sampleId));
+    }
+
+    void Clear() noexcept
+    {
+        entries_.clear();
+    }
+
+private:
+    const Study &study_;
+    std::size_t gridSize_;
+    std::map<std::string, std::unique_ptr<SampleDistribution>> entries_;
+
+    std::unique_ptr<SampleDistribution> Build(const std::string &sampleId) const
+    {
+        std::vector<std::pair<Reduction::CompensatedSum, int>> laboratorySums;
+        std::unordered_map<std::string_view, std::size_t> laboratoryIndexes;
+        study_.ForEachMeasurementResult([&](const MeasurementResult &result)
+                                        {
+                                            if (std::string_view(result.GetSampleId()) != sampleId)
+                                            {
+                                                return;
+                                            }
+
+                                            const auto [it, inserted] = laboratoryIndexes.emplace(result.GetLaboratoryId(), laboratorySums.size());
+                                            if (inserted)
+                                            {
+                                                laboratorySums.emplace_back(Reduction::CompensatedSum(), 0);
+                                            }
+                                            laboratorySums[it->second].first.Add(result.GetValue());
+                                            ++laboratorySums[it->second].second;
+                                        });
+
+        std::unique_ptr<SampleDistribution> distribution;
+        if (laboratorySums.empty())
+        {
+            return distribution;
+        }
+
+        distribution = std::make_unique<SampleDistribution>();
+        distribution->sampleId = sampleId;
+        distribution->values.reserve(laboratorySums.size());
+        for (const auto &[sum, count] : laboratorySums)
+        {
+            distribution->values.push_back(sum.GetSum() / count);
+        }
+
+        distribution->histogram = ComputeHistogram(distribution->values);
+        distribution->defaultBandwidth = BinnedKernelDensity::ReferenceBandwidth(distribution->values);
+        distribution->density = BinnedKernelDensity::FromValues(distribution->values, gridSize_, GridPadding * MaxBandwidthFactor);
+        distribution->maxBandwidth = distribution->defaultBandwidth * MaxBandwidthFactor;
+        distribution->minBandwidth = std::min(std::max(distribution->defaultBandwidth * MinBandwidthFactor,
+                                                       distribution->density.GetStep() * 2.0),
+                                              distribution->maxBandwidth);
+        return distribution;
+    }
+};
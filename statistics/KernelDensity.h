@@ -0,0 +1,215 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+
+#include "Fft.h"
+#include "Reduction.h"
+
+// Equal-width histogram over [lower, upper]
+struct Histogram
+{
+    double lower = 0.0;
+    double binWidth = 0.0;
+    std::vector<std::size_t> counts;
+
+    double GetUpper() const noexcept { return lower + binWidth * static_cast<double>(counts.size()); }
+};
+
+// Gaussian kernel density estimate evaluated on a regular grid.
+//
+// The data are linearly binned onto the grid once (O(n)); each density
+// evaluation is then a circular convolution of the bin weights with the
+// sampled kernel, done with zero-padded FFTs (O(m log m)). The transform of
+// the bin weights is kept, so changing the bandwidth costs one kernel FFT,
+// one pointwise product and one inverse FFT, independent of n.
+class BinnedKernelDensity
+{
+public:
+    BinnedKernelDensity() = default;
+
+    // The grid spans [lower, upper] with gridSize points (gridSize >= 2)
+    BinnedKernelDensity(const std::vector<double> &values, double lower, double upper, std::size_t gridSize = 512)
+        : lower_(lower),
+          gridSize_(gridSize)
+    {
+        if (gridSize < 2 || !(upper > lower))
+        {
+            throw std::invalid_argument("BinnedKernelDensity: Grid needs >= 2 points and upper > lower.");
+        }
+
+        step_ = (upper - lower) / static_cast<double>(gridSize - 1);
+        count_ = values.size();
+
+        // Linear binning: each value splits its unit weight between the two nearest grid points
+        std::vector<double> weights(gridSize, 0.0);
+        for (const double value : values)
+        {
+            const double position = (value - lower) / step_;
+            if (!(position >= 0.0) || position > static_cast<double>(gridSize - 1))
+            {
+                continue;
+            }
+
+            const auto left = std::min(static_cast<std::size_t>(position), gridSize - 2);
+            const double fraction = position - static_cast<double>(left);
+            weights[left] += 1.0 - fraction;
+            weights[left + 1] += fraction;
+        }
+
+        // Zero padding to twice the grid keeps the circular convolution from wrapping
+        paddedSize_ = Fft::NextPowerOfTwo(2 * gridSize);
+        binTransform_.assign(paddedSize_, {0.0, 0.0});
+        for (std::size_t index = 0; index < gridSize; ++index)
+        {
+            binTransform_[index] = weights[index];
+        }
+        Fft::Transform(binTransform_);
+    }
+
+    // Grid sized from the data: range extended by `padding` reference bandwidths on each side
+    static BinnedKernelDensity FromValues(const std::vector<double> &values, std::size_t gridSize = 512, double padding = 4.0)
+    {
+        if (values.empty())
+        {
+            throw std::invalid_argument("BinnedKernelDensity::FromValues: No values.");
+        }
+
+        const auto [minIt, maxIt] = std::minmax_element(values.begin(), values.end());
+        const double bandwidth = ReferenceBandwidth(values);
+        return BinnedKernelDensity(values, *minIt - padding * bandwidth, *maxIt + padding * bandwidth, gridSize);
+    }
+
+    // Silverman's bandwidth, or a small fraction of the magnitude of the data
+    // when that is zero (fewer than two distinct values); always > 0
+    static double ReferenceBandwidth(const std::vector<double> &values)
+    {
+        const double bandwidth = SilvermanBandwidth(values);
+        if (bandwidth > 0.0)
+        {
+            return bandwidth;
+        }
+
+        double magnitude = 1.0;
+        for (const double value : values)
+        {
+            magnitude = std::max(magnitude, std::abs(value));
+        }
+        return magnitude * 1e-3;
+    }
+
+    // Silverman's rule of thumb, 0.9 min(s, IQR / 1.34) n^(-1/5)
+    static double SilvermanBandwidth(std::vector<double> values)
+    {
+        if (values.size() < 2)
+        {
+            return 0.0;
+        }
+
+        std::sort(values.begin(), values.end());
+        const double s = std::sqrt(Reduction::Variance(values));
+        const double iqr = Quantile(values, 0.75) - Quantile(values, 0.25);
+        const double spread = iqr > 0.0 ? std::min(s, iqr / 1.34) : s;
+        return 0.9 * spread * std::pow(static_cast<double>(values.size()), -0.2);
+    }
+
+    std::size_t GetGridSize() const noexcept { return gridSize_; }
+    std::size_t GetCount() const noexcept { return count_; }
+    double GetLower() const noexcept { return lower_; }
+    double GetStep() const noexcept { return step_; }
+    double GetGridPoint(std::size_t index) const noexcept { return lower_ + step_ * static_cast<double>(index); }
+
+    // Density at every grid point for the given bandwidth (> 0)
+    std::vector<double> Evaluate(double bandwidth) const
+    {
+        if (!(bandwidth > 0.0))
+        {
+            throw std::invalid_argument("BinnedKernelDensity::Evaluate: Bandwidth must be > 0.");
+        }
+
+        std::vector<double> density(gridSize_, 0.0);
+        if (count_ == 0)
+        {
+            return density;
+        }
+
+        // Kernel sampled at lags -L..L, truncated at 5 bandwidths, stored in wrap-around order
+        const double norm = 1.0 / (static_cast<double>(count_) * bandwidth * std::sqrt(2.0 * std::acos(-1.0)));
+        const std::size_t maxLag = std::min(gridSize_ - 1, static_cast<std::size_t>(std::ceil(5.0 * bandwidth / step_)));
+
+        std::vector<std::complex<double>> kernel(paddedSize_, {0.0, 0.0});
+        for (std::size_t lag = 0; lag <= maxLag; ++lag)
+        {
+            const double z = static_cast<double>(lag) * step_ / bandwidth;
+            const double value = norm * std::exp(-0.5 * z * z);
+            kernel[lag] = value;
+            if (lag > 0)
+            {
+                kernel[paddedSize_ - lag] = value;
+            }
+        }
+        Fft::Transform(kernel);
+
+        for (std::size_t index = 0; index < paddedSize_; ++index)
+        {
+            kernel[index] *= binTransform_[index];
+        }
+        Fft::Transform(kernel, true);
+
+        for (std::size_t index = 0; index < gridSize_; ++index)
+        {
+            density[index] = std::max(0.0, kernel[index].real());
+        }
+        return density;
+    }
+
+private:
+    double lower_ = 0.0;
+    double step_ = 1.0;
+    std::size_t gridSize_ = 0;
+    std::size_t paddedSize_ = 0;
+    std::size_t count_ = 0;
+    std::vector<std::complex<double>> binTransform_;
+
+    // Linear interpolation between order statistics (sorted input)
+    static double Quantile(const std::vector<double> &sorted, double probability)
+    {
+        const double position = probability * static_cast<double>(sorted.size() - 1);
+        const auto below = static_cast<std::size_t>(position);
+        const std::size_t above = std::min(below + 1, sorted.size() - 1);
+        return sorted[below] + (position - static_cast<double>(below)) * (sorted[above] - sorted[below]);
+    }
+};
+
+// Histogram with binCount equal-width bins over [min, max] of the values;
+// binCount == 0 uses Sturges' rule, ceil(log2 n) + 1
+inline Histogram ComputeHistogram(const std::vector<double> &values, std::size_t binCount = 0)
+{
+    Histogram histogram;
+    if (values.empty())
+    {
+        return histogram;
+    }
+
+    if (binCount == 0)
+    {
+        binCount = static_cast<std::size_t>(std::ceil(std::log2(static_cast<double>(values.size())))) + 1;
+    }
+
+    const auto [minIt, maxIt] = std::minmax_element(values.begin(), values.end());
+    const double range = *maxIt - *minIt;
+
+    histogram.lower = *minIt;
+    histogram.binWidth = range > 0.0 ? range / static_cast<double>(binCount) : 1.0;
+    histogram.counts.assign(binCount, 0);
+    for (const double value : values)
+    {
+        const auto bin = static_cast<std::size_t>((value - histogram.lower) / histogram.binWidth);
+        ++histogram.counts[std::min(bin, binCount - 1)];
+    }
+    return histogram;
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <string_view>
+#include <optional>
+#include <cstdint>
+
+namespace DateTimeUtils
+{
+    // Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant's days_from_civil)
+    constexpr std::int64_t DaysFromCivil(std::int64_t year, unsigned month, unsigned day) noexcept
+    {
+        year -= month <= 2 ? 1 : 0;
+        const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+        const unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+        const unsigned dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        return era * 146097 + static_cast<std::int64_t>(dayOfEra) - 719468;
+    }
+
+    constexpr bool IsLeapYear(int year) noexcept
+    {
+        return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    }
+
+    constexpr unsigned DaysInMonth(int year, unsigned month) noexcept
+    {
+        constexpr unsigned days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        return month == 2 && IsLeapYear(year) ? 29 : days[month - 1];
+    }
+
+    namespace Detail
+    {
+        // Reads exactly `count` decimal digits starting at `position`
+        inline bool ReadDigits(std::string_view text, std::size_t &position, std::size_t count, int &value) noexcept
+        {
+            if (position + count > text.size())
+            {
+                return false;
+            }
+
+            int result = 0;
+            for (std::size_t index = 0; index < count; ++index)
+            {
+                const char c = text[position + index];
+                if (c < '0' || c > '9')
+                {
+                    return false;
+                }
+                result = result * 10 + (c - '0');
+            }
+
+            position += count;
+            value = result;
+            return true;
+        }
+
+        inline bool Consume(std::string_view text, std::size_t &position, char expected) noexcept
+        {
+            if (position < text.size() && text[position] == expected)
+            {
+                ++position;
+                return true;
+            }
+            return false;
+        }
+    }
+
+    // Parses an ISO 8601 date or date-time into milliseconds since the Unix epoch (UTC).
+    //
+    // Accepted forms: YYYY-MM-DD, YYYY-MM-DDThh:mm, YYYY-MM-DDThh:mm:ss[.fraction],
+    // with 'T' or ' ' as separator and an optional 'Z', +hh:mm, -hh:mm, +hhmm or +hh
+    // offset. A missing offset is taken as UTC. Fractions beyond milliseconds are
+    // truncated. Returns std::nullopt for anything else.
+    inline std::optional<std::int64_t> ParseIso8601ToEpochMillis(std::string_view text) noexcept
+    {
+        std::size_t position = 0;
+        int year = 0;
+        int month = 0;
+        int day = 0;
+
+        if (!Detail::ReadDigits(text, position, 4, year) ||
+            !Detail::Consume(text, position, '-') ||
+            !Detail::ReadDigits(text, position, 2, month) ||
+            !Detail::Consume(text, position, '-') ||
+            !Detail::ReadDigits(text, position, 2, day))
+        {
+            return std::nullopt;
+        }
+
+        if (month < 1 || month > 12 || day < 1 ||
+            static_cast<unsigned>(day) > DaysInMonth(year, static_cast<unsigned>(month)))
+        {
+            return std::nullopt;
+        }
+
+        int hour = 0;
+        int minute = 0;
+        int second = 0;
+        int millis = 0;
+        std::int64_t offsetMinutes = 0;
+
+        if (position < text.size())
+        {
+            if (!Detail::Consume(text, position, 'T') && !Detail::Consume(text, position, ' '))
+            {
+                return std::nullopt;
+            }
+
+            if (!Detail::ReadDigits(text, position, 2, hour) ||
+                !Detail::Consume(text, position, ':') ||
+                !Detail::ReadDigits(text, position, 2, minute))
+            {
+                return std::nullopt;
+            }
+
+            if (Detail::Consume(text, position, ':'))
+            {
+                if (!Detail::ReadDigits(text, position, 2, second))
+                {
+                    return std::nullopt;
+                }
+
+                if (Detail::Consume(text, position, '.') || Detail::Consume(text, position, ','))
+                {
+                    std::size_t digits = 0;
+                    while (position < text.size() && text[position] >= '0' && text[position] <= '9')
+                    {
+                        if (digits < 3)
+                        {
+                            millis = millis * 10 + (text[position] - '0');
+                        }
+                        ++digits;
+                        ++position;
+                    }
+
+                    if (digits == 0)
+                    {
+                        return std::nullopt;
+                    }
+
+                    for (; digits < 3; ++digits)
+                    {
+                        millis *= 10;
+                    }
+                }
+            }
+
+            if (hour > 23 || minute > 59 || second > 59)
+            {
+                return std::nullopt;
+            }
+
+            if (Detail::Consume(text, position, 'Z'))
+            {
+                // UTC
+            }
+            else if (position < text.size() && (text[position] == '+' || text[position] == '-'))
+            {
+                const bool negative = text[position] == '-';
+                ++position;
+
+                int offsetHour = 0;
+                int offsetMinute = 0;
+                if (!Detail::ReadDigits(text, position, 2, offsetHour))
+                {
+                    return std::nullopt;
+                }
+
+                if (position < text.size())
+                {
+                    Detail::Consume(text, position, ':');
+                    if (!Detail::ReadDigits(text, position, 2, offsetMinute))
+                    {
+                        return std::nullopt;
+                    }
+                }
+
+                if (offsetHour > 23 || offsetMinute > 59)
+                {
+                    return std::nullopt;
+                }
+
+                offsetMinutes = (negative ? -1 : 1) * (offsetHour * 60 + offsetMinute);
+            }
+        }
+
+        if (position != text.size())
+        {
+            return std::nullopt;
+        }
+
+        const std::int64_t days = DaysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day));
+        const std::int64_t seconds = days * 86400 + hour * 3600 + minute * 60 + second - offsetMinutes * 60;
+        return seconds * 1000 + millis;
+    }
+}
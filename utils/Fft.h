@@ -0,0 +1,83 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <utility>
+#include <stdexcept>
+
+namespace Fft
+{
+    inline bool IsPowerOfTwo(std::size_t value) noexcept
+    {
+        return value != 0 && (value & (value - 1)) == 0;
+    }
+
+    inline std::size_t NextPowerOfTwo(std::size_t value) noexcept
+    {
+        std::size_t result = 1;
+        while (result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    // In-place iterative radix-2 FFT; data.size() must be a power of two.
+    // The inverse transform is scaled by 1/n.
+    inline void Transform(std::vector<std::complex<double>> &data, bool inverse = false)
+    {
+        const std::size_t size = data.size();
+        if (!IsPowerOfTwo(size))
+        {
+            throw std::invalid_argument("Fft::Transform: Size must be a power of two.");
+        }
+
+        // Bit-reversal permutation
+        for (std::size_t index = 1, reversed = 0; index < size; ++index)
+        {
+            std::size_t bit = size >> 1;
+            for (; reversed & bit; bit >>= 1)
+            {
+                reversed ^= bit;
+            }
+            reversed ^= bit;
+
+            if (index < reversed)
+            {
+                std::swap(data[index], data[reversed]);
+            }
+        }
+
+        const double pi = std::acos(-1.0);
+        for (std::size_t length = 2; length <= size; length <<= 1)
+        {
+            const double angle = (inverse ? 2.0 : -2.0) * pi / static_cast<double>(length);
+            const std::complex<double> step(std::cos(angle), std::sin(angle));
+            const std::size_t half = length / 2;
+
+            for (std::size_t start = 0; start < size; start += length)
+            {
+                std::complex<double> twiddle(1.0, 0.0);
+                for (std::size_t offset = 0; offset < half; ++offset)
+                {
+                    const std::complex<double> even = data[start + offset];
+                    const std::complex<double> odd = data[start + offset + half] * twiddle;
+                    data[start + offset] = even + odd;
+                    data[start + offset + half] = even - odd;
+                    twiddle *= step;
+                }
+            }
+        }
+
+        if (inverse)
+        {
+            const double scale = 1.0 / static_cast<double>(size);
+            for (auto &value : data)
+            {
+                value *= scale;
+            }
+        }
+    }
+}
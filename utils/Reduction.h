@@ -0,0 +1,244 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+
+// Reproducible floating-point reductions.
+//
+// Every sum is evaluated with the same fixed-shape tree, which depends only on
+// the number of terms:
+//
+//   - the input is cut into blocks of BlockSize terms;
+//   - inside a block, terms are spread over LaneCount independent accumulators
+//     (term i goes to lane i % LaneCount), and the lanes are combined pairwise;
+//   - block sums are combined with a pairwise tree over the block index.
+//
+// The lane count is part of the algorithm, not of the hardware: the compiler
+// may map the lanes onto SSE, AVX or scalar registers, but the association
+// order stays the same, so results are bit-identical across machines, SIMD
+// widths and thread counts. The error bound grows with log(n) instead of n.
+//
+// This relies on the compiler neither reassociating floating-point math (no
+// -ffast-math / -fassociative-math) nor contracting a*b + c into an FMA,
+// which GCC does by default on FMA-capable targets (-mfma, -march=native)
+// and would round differently from machines without FMA. Contraction is
+// switched off for this header below; term functors passed to SumOf are
+// usually inlined into it, but build with -ffp-contract=off (see README) so
+// that terms evaluated elsewhere are covered too.
+#if defined(__clang__)
+#pragma float_control(push)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC optimize("fp-contract=off")
+#elif defined(_MSC_VER)
+#pragma fp_contract(off)
+#endif
+
+namespace Reduction
+{
+    constexpr std::size_t LaneCount = 8;
+    constexpr std::size_t BlockSize = 1024;
+
+    namespace Detail
+    {
+        template <typename Term>
+        double SumBlock(std::size_t first, std::size_t last, const Term &term)
+        {
+            double lanes[LaneCount] = {};
+
+            std::size_t index = first;
+            for (; index + LaneCount <= last; index += LaneCount)
+            {
+                for (std::size_t lane = 0; lane < LaneCount; ++lane)
+                {
+                    lanes[lane] += term(index + lane);
+                }
+            }
+            for (std::size_t lane = 0; index < last; ++index, ++lane)
+            {
+                lanes[lane] += term(index);
+            }
+
+            return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) +
+                   ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+        }
+
+        inline double CombinePairwise(const double *sums, std::size_t count) noexcept
+        {
+            if (count == 0)
+            {
+                return 0.0;
+            }
+            if (count == 1)
+            {
+                return sums[0];
+            }
+
+            const std::size_t half = count / 2;
+            return CombinePairwise(sums, half) + CombinePairwise(sums + half, count - half);
+        }
+
+        inline std::size_t BlockCount(std::size_t count) noexcept
+        {
+            return (count + BlockSize - 1) / BlockSize;
+        }
+
+        inline std::size_t ResolveThreadCount(std::size_t threadCount, std::size_t blocks) noexcept
+        {
+            if (threadCount == 0)
+            {
+                threadCount = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+            }
+            return std::max<std::size_t>(1, std::min(threadCount, blocks));
+        }
+    }
+
+    static_assert(LaneCount == 8, "SumBlock combines exactly eight lanes");
+
+    // Sum of term(0) + ... + term(count - 1); term must return double
+    template <typename Term>
+    double SumOf(std::size_t count, const Term &term)
+    {
+        const std::size_t blocks = Detail::BlockCount(count);
+        if (blocks <= 1)
+        {
+            return Detail::SumBlock(0, count, term);
+        }
+
+        std::vector<double> blockSums(blocks);
+        for (std::size_t block = 0; block < blocks; ++block)
+        {
+            blockSums[block] = Detail::SumBlock(block * BlockSize, std::min(count, (block + 1) * BlockSize), term);
+        }
+        return Detail::CombinePairwise(blockSums.data(), blocks);
+    }
+
+    // Same result as SumOf, with blocks spread over threadCount threads
+    // (0 uses the hardware thread count). term must be safe to call concurrently.
+    template <typename Term>
+    double ParallelSumOf(std::size_t count, const Term &term, std::size_t threadCount = 0)
+    {
+        const std::size_t blocks = Detail::BlockCount(count);
+        threadCount = Detail::ResolveThreadCount(threadCount, blocks);
+        if (threadCount == 1)
+        {
+            return SumOf(count, term);
+        }
+
+        std::vector<double> blockSums(blocks);
+        auto worker = [&](std::size_t threadIndex)
+        {
+            // Static interleaved assignment; which thread sums a block does not affect the result
+            for (std::size_t block = threadIndex; block < blocks; block += threadCount)
+            {
+                blockSums[block] = Detail::SumBlock(block * BlockSize, std::min(count, (block + 1) * BlockSize), term);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount - 1);
+        for (std::size_t threadIndex = 1; threadIndex < threadCount; ++threadIndex)
+        {
+            threads.emplace_back(worker, threadIndex);
+        }
+        worker(0);
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        return Detail::CombinePairwise(blockSums.data(), blocks);
+    }
+
+    inline double Sum(const double *values, std::size_t count)
+    {
+        return SumOf(count, [values](std::size_t index)
+                     { return values[index]; });
+    }
+
+    inline double Sum(const std::vector<double> &values)
+    {
+        return Sum(values.data(), values.size());
+    }
+
+    inline double ParallelSum(const std::vector<double> &values, std::size_t threadCount = 0)
+    {
+        const double *data = values.data();
+        return ParallelSumOf(values.size(), [data](std::size_t index)
+                             { return data[index]; }, threadCount);
+    }
+
+    inline double DotProduct(const std::vector<double> &a, const std::vector<double> &b)
+    {
+        const double *left = a.data();
+        const double *right = b.data();
+        return SumOf(std::min(a.size(), b.size()), [left, right](std::size_t index)
+                     { return left[index] * right[index]; });
+    }
+
+    // Arithmetic mean; NaN for no values
+    inline double Mean(const std::vector<double> &values)
+    {
+        return values.empty() ? std::nan("") : Sum(values) / static_cast<double>(values.size());
+    }
+
+    // Sample variance (n - 1) by the two-pass algorithm; NaN for fewer than two values
+    inline double Variance(const std::vector<double> &values)
+    {
+        if (values.size() < 2)
+        {
+            return std::nan("");
+        }
+
+        const double mean = Mean(values);
+        const double *data = values.data();
+        const double squares = SumOf(values.size(), [data, mean](std::size_t index)
+                                     { return (data[index] - mean) * (data[index] - mean); });
+        return squares / static_cast<double>(values.size() - 1);
+    }
+
+    // Streaming sum with Neumaier compensation, for values that arrive one at a
+    // time. Deterministic for a given input order.
+    class CompensatedSum
+    {
+    public:
+        void Add(double value) noexcept
+        {
+            const double total = sum_ + value;
+            if (std::abs(sum_) >= std::abs(value))
+            {
+                compensation_ += (sum_ - total) + value;
+            }
+            else
+            {
+                compensation_ += (value - total) + sum_;
+            }
+            sum_ = total;
+        }
+
+        double GetSum() const noexcept { return sum_ + compensation_; }
+
+    private:
+        double sum_ = 0.0;
+        double compensation_ = 0.0;
+    };
+}
+
+#if defined(__clang__)
+#pragma float_control(pop)
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#elif defined(_MSC_VER)
+// MSVC's fp_contract has no push/pop form; restore the /fp:precise default,
+// which is on before Visual Studio 2022 and off from it on. With /fp:contract
+// on 2022 the rest of the translation unit stays uncontracted.
+#if _MSC_VER < 1930
+#pragma fp_contract(on)
+#else
+#pragma fp_contract(off)
+#endif
+#endif
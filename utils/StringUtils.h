@@ -1,26 +1,33 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <cctype>
 
 namespace StringUtils
 {
-    // Removes leading and trailing whitespace and returns a new string
-    inline std::string TrimCopy(const std::string &text)
+    // Removes leading and trailing whitespace without allocating; the result views into text
+    inline std::string_view TrimView(std::string_view text) noexcept
     {
-        auto left = text.begin();
-        auto right = text.end();
+        std::size_t left = 0;
+        std::size_t right = text.size();
 
-        while (left != right && std::isspace(static_cast<unsigned char>(*left)))
+        while (left != right && std::isspace(static_cast<unsigned char>(text[left])))
         {
             ++left;
         }
 
-        while (right != left && std::isspace(static_cast<unsigned char>(*(right - 1))))
+        while (right != left && std::isspace(static_cast<unsigned char>(text[right - 1])))
         {
             --right;
         }
 
-        return std::string(left, right);
+        return text.substr(left, right - left);
+    }
+
+    // Removes leading and trailing whitespace and returns a new string
+    inline std::string TrimCopy(std::string_view text)
+    {
+        return std::string(TrimView(text));
     }
 }